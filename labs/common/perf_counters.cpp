@@ -0,0 +1,156 @@
+// perf_counters.cpp — perf_event_open plumbing for perf_counters.hpp
+
+#include "perf_counters.hpp"
+
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace perfc {
+namespace {
+
+struct EventSpec {
+  const char *name; // counter name in the report
+  std::uint32_t type;
+  std::uint64_t config;
+};
+
+constexpr std::uint64_t cache_event(std::uint64_t id, std::uint64_t op, std::uint64_t result) {
+  return id | (op << 8) | (result << 16);
+}
+
+constexpr EventSpec kSpecs[kNumEvents] = {
+    {"cycles", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+    {"instructions", PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+    {"L1D_miss", PERF_TYPE_HW_CACHE,
+     cache_event(PERF_COUNT_HW_CACHE_L1D, PERF_COUNT_HW_CACHE_OP_READ, PERF_COUNT_HW_CACHE_RESULT_MISS)},
+    {"LLC_miss", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+    {"br_miss", PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+    {"dTLB_miss", PERF_TYPE_HW_CACHE,
+     cache_event(PERF_COUNT_HW_CACHE_DTLB, PERF_COUNT_HW_CACHE_OP_READ, PERF_COUNT_HW_CACHE_RESULT_MISS)},
+};
+
+bool enabled() {
+  static const bool on = [] {
+    const char *v = std::getenv("BENCH_PERF");
+    return !(v && std::strcmp(v, "0") == 0);
+  }();
+  return on;
+}
+
+// Once an event has failed it is not retried: every benchmark run would
+// otherwise pay the failing syscalls again.
+std::atomic<bool> g_unavailable[kNumEvents];
+
+// The counted() loop running on this thread, for pause_timing/resume_timing.
+// Benchmark threads (->Threads(n)) each run their own loop.
+thread_local Counted *t_active = nullptr;
+
+int open_event(Event e) {
+  if (g_unavailable[e].load(std::memory_order_relaxed)) return -1;
+  perf_event_attr attr{};
+  attr.size = sizeof(attr);
+  attr.type = kSpecs[e].type;
+  attr.config = kSpecs[e].config;
+  attr.disabled = 1;
+  attr.inherit = 1;
+  attr.exclude_kernel = 1; // allowed at perf_event_paranoid <= 2
+  attr.exclude_hv = 1;
+  attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+  const int fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, PERF_FLAG_FD_CLOEXEC));
+  if (fd < 0 && !g_unavailable[e].exchange(true)) {
+    std::fprintf(stderr, "perf_counters: %s unavailable (%s); not reported\n", kSpecs[e].name,
+                 std::strerror(errno));
+  }
+  return fd;
+}
+
+} // namespace
+
+Group::Group() {
+  fd_.fill(-1);
+  if (!enabled()) return;
+  for (int e = 0; e < kNumEvents; ++e) fd_[e] = open_event(static_cast<Event>(e));
+}
+
+Group::~Group() {
+  for (int fd : fd_) {
+    if (fd >= 0) close(fd);
+  }
+}
+
+bool Group::any() const {
+  for (int fd : fd_) {
+    if (fd >= 0) return true;
+  }
+  return false;
+}
+
+void Group::start() {
+  for (int fd : fd_) {
+    if (fd < 0) continue;
+    ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+    ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+  }
+}
+
+// Enable/disable reach the inherited counters of live child threads too.
+void Group::stop() {
+  for (int fd : fd_) {
+    if (fd >= 0) ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+  }
+}
+
+void Group::resume() {
+  for (int fd : fd_) {
+    if (fd >= 0) ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+  }
+}
+
+double Group::value(Event e) const {
+  if (fd_[e] < 0) return -1.0;
+  std::uint64_t buf[3] = {}; // value, time_enabled, time_running
+  if (read(fd_[e], buf, sizeof(buf)) != static_cast<ssize_t>(sizeof(buf))) return -1.0;
+  if (buf[2] == 0) return 0.0; // never scheduled on the PMU
+  return static_cast<double>(buf[0]) * static_cast<double>(buf[1]) / static_cast<double>(buf[2]);
+}
+
+void Counted::start() {
+  t_active = this;
+  group_.start();
+}
+
+void Counted::finish() {
+  if (t_active == this) t_active = nullptr;
+  if (!group_.any()) return;
+  group_.stop();
+  if (st_.iterations() == 0) return;
+  double v[kNumEvents];
+  for (int e = 0; e < kNumEvents; ++e) {
+    v[e] = group_.value(static_cast<Event>(e));
+    if (v[e] >= 0) st_.counters[kSpecs[e].name] = benchmark::Counter(v[e], benchmark::Counter::kAvgIterations);
+  }
+  // A ratio: averaged, not summed, over ->Threads(n) benchmark threads.
+  if (v[kCycles] > 0 && v[kInstructions] >= 0) {
+    st_.counters["IPC"] = benchmark::Counter(v[kInstructions] / v[kCycles], benchmark::Counter::kAvgThreads);
+  }
+}
+
+void pause_timing(benchmark::State &st) {
+  if (t_active && &t_active->st_ == &st) t_active->group_.stop();
+  st.PauseTiming();
+}
+
+void resume_timing(benchmark::State &st) {
+  st.ResumeTiming();
+  if (t_active && &t_active->st_ == &st) t_active->group_.resume();
+}
+
+} // namespace perfc
@@ -0,0 +1,109 @@
+// perf_counters.hpp — Hardware counters around a Google Benchmark loop.
+//
+//   for (auto _ : perfc::counted(st)) { ... }
+//
+// behaves like `for (auto _ : st)`. It also counts cycles, instructions, L1D
+// read misses, LLC misses, branch misses and dTLB read misses with
+// perf_event_open, from the moment the benchmark timer starts to the moment
+// the loop ends. Per-iteration counters and IPC are added to st, so they land
+// next to the timing in the console and JSON output:
+//   cycles  instructions  IPC  L1D_miss  LLC_miss  br_miss  dTLB_miss
+//
+// What is counted: the calling thread, plus threads it creates inside the
+// loop, once they have exited (perf inherit; joined workers are in, a pool
+// started before the loop is not). Counts are scaled by enabled/running time
+// if the kernel multiplexes the PMU.
+//
+// Untimed setup must use the perfc helpers rather than the State's own calls,
+// or it is counted while the timer is off:
+//   perfc::pause_timing(st);  // st.PauseTiming() + stop counting
+//   ...setup...
+//   perfc::resume_timing(st); // resume counting + st.ResumeTiming()
+//
+// Events that cannot be opened (no PMU in the VM/container, perf_event_paranoid
+// too high, event unsupported) are left out of the report; each gets one note
+// on stderr. With none available the loop runs like plain `st`. Setting
+// BENCH_PERF=0 in the environment turns counting off.
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+#include <benchmark/benchmark.h>
+
+namespace perfc {
+
+enum Event : int { kCycles, kInstructions, kL1dMiss, kLlcMiss, kBranchMiss, kDtlbMiss, kNumEvents };
+
+// One perf fd per available event, on the calling thread, disabled until
+// start(). Move-free and copy-free: it owns the fds.
+class Group {
+public:
+  Group();
+  ~Group();
+  Group(const Group &) = delete;
+  Group &operator=(const Group &) = delete;
+
+  bool any() const;
+  void start();  // reset and enable
+  void stop();   // disable, keeping the counts
+  void resume(); // enable without reset
+  // Scaled count between start() and stop(); negative if the event is not open.
+  double value(Event e) const;
+
+private:
+  std::array<int, kNumEvents> fd_;
+};
+
+// Range over a State: iterating it drives the State's own iterator, starts
+// the Group after the timer starts (State::end()) and, on the end test that
+// finishes the loop, stops it and writes the counters into the State.
+class Counted {
+public:
+  class Iterator {
+  public:
+    Iterator(benchmark::State::StateIterator it, Counted *owner) : it_(it), owner_(owner) {}
+    benchmark::State::StateIterator::Value operator*() const { return *it_; }
+    Iterator &operator++() {
+      ++it_;
+      return *this;
+    }
+    bool operator!=(const Iterator &end) const {
+      if (it_ != end.it_) return true;
+      owner_->finish();
+      return false;
+    }
+
+  private:
+    benchmark::State::StateIterator it_;
+    Counted *owner_;
+  };
+
+  explicit Counted(benchmark::State &st) : st_(st) {}
+  Iterator begin() { return {st_.begin(), this}; }
+  Iterator end() {
+    Iterator e{st_.end(), this}; // State::end() starts the timer
+    start();
+    return e;
+  }
+
+private:
+  friend void pause_timing(benchmark::State &st);
+  friend void resume_timing(benchmark::State &st);
+
+  void start();
+  void finish();
+
+  benchmark::State &st_;
+  Group group_;
+};
+
+inline Counted counted(benchmark::State &st) { return Counted(st); }
+
+// PauseTiming/ResumeTiming that also stop and restart the counters of the
+// counted() loop running on this thread. Outside such a loop they are the
+// plain State calls.
+void pause_timing(benchmark::State &st);
+void resume_timing(benchmark::State &st);
+
+} // namespace perfc
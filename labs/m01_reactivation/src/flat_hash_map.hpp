@@ -0,0 +1,228 @@
+#pragma once
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <string_view>
+#include <utility>
+
+#if defined(__SSE2__)
+  #include <emmintrin.h>
+#endif
+
+// SwissTable-style open-addressing map from a string key to a record that
+// carries its own key (e.g. Payload keyed on Payload::s via KeyOf).
+//
+// Layout: one control byte per slot plus a flat slot array. A control byte is
+// kEmpty, kDeleted, or the low 7 bits of the full slot's hash (h2). A lookup
+// hashes once, starts at h1 = hash >> 7 and scans 16 control bytes per step
+// with one SSE2 compare: only slots whose h2 matches (1/128 false positives)
+// are touched, then the stored 64-bit hash, and only then the key bytes.
+// Growth rehashes from the stored hashes without reading any key.
+//
+// Probing is triangular over 16-slot groups, so every group is visited on a
+// power-of-two table. The table grows at 7/8 load; erase leaves a tombstone,
+// and tombstones are purged by an in-place-sized rehash when they are what
+// exhausted the growth budget.
+template <class V, class KeyOf, class Hash = std::hash<std::string_view>>
+class FlatHashMap {
+  using ctrl_t = std::int8_t;
+  static constexpr ctrl_t kEmpty = -128;  // 0b10000000
+  static constexpr ctrl_t kDeleted = -2;  // 0b11111110
+  static constexpr std::size_t kGroupWidth = 16;
+
+  // Bit i set = control byte i of the group matched.
+  struct Group {
+#if defined(__SSE2__)
+    __m128i ctrl;
+    explicit Group(const ctrl_t *p) : ctrl(_mm_loadu_si128(reinterpret_cast<const __m128i *>(p))) {}
+    std::uint32_t match(ctrl_t h2) const {
+      return static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), ctrl)));
+    }
+    std::uint32_t match_empty() const { return match(kEmpty); }
+    // Full slots hold h2 in 0..127, so kEmpty/kDeleted are the sign-bit bytes.
+    std::uint32_t match_empty_or_deleted() const { return static_cast<std::uint32_t>(_mm_movemask_epi8(ctrl)); }
+#else
+    ctrl_t ctrl[kGroupWidth];
+    explicit Group(const ctrl_t *p) { std::memcpy(ctrl, p, kGroupWidth); }
+    std::uint32_t match(ctrl_t h2) const {
+      std::uint32_t m = 0;
+      for (std::size_t i = 0; i < kGroupWidth; ++i) m |= static_cast<std::uint32_t>(ctrl[i] == h2) << i;
+      return m;
+    }
+    std::uint32_t match_empty() const { return match(kEmpty); }
+    std::uint32_t match_empty_or_deleted() const {
+      std::uint32_t m = 0;
+      for (std::size_t i = 0; i < kGroupWidth; ++i) m |= static_cast<std::uint32_t>(ctrl[i] < 0) << i;
+      return m;
+    }
+#endif
+  };
+
+  struct Slot {
+    std::size_t hash;
+    V value;
+  };
+
+public:
+  FlatHashMap() = default;
+  explicit FlatHashMap(std::size_t n) { reserve(n); }
+  FlatHashMap(const FlatHashMap &) = delete;
+  FlatHashMap &operator=(const FlatHashMap &) = delete;
+  FlatHashMap(FlatHashMap &&o) noexcept { swap(o); }
+  FlatHashMap &operator=(FlatHashMap &&o) noexcept {
+    FlatHashMap(std::move(o)).swap(*this);
+    return *this;
+  }
+  ~FlatHashMap() { destroy(); }
+
+  void swap(FlatHashMap &o) noexcept {
+    std::swap(ctrl_, o.ctrl_);
+    std::swap(slots_, o.slots_);
+    std::swap(capacity_, o.capacity_);
+    std::swap(size_, o.size_);
+    std::swap(growth_left_, o.growth_left_);
+  }
+
+  std::size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+  std::size_t capacity() const { return capacity_; }
+
+  // Room for n records without rehashing.
+  void reserve(std::size_t n) {
+    const std::size_t want = std::max(kGroupWidth, std::bit_ceil(n + n / 7 + 1));
+    if (want > capacity_) resize(want);
+  }
+
+  V *find(std::string_view key) {
+    return const_cast<V *>(std::as_const(*this).find(key));
+  }
+  const V *find(std::string_view key) const {
+    const std::size_t i = find_index(key, Hash{}(key));
+    return i == kNpos ? nullptr : &slots_[i].value;
+  }
+  bool contains(std::string_view key) const { return find(key) != nullptr; }
+
+  // Inserts v unless a record with its key exists; returns the record under
+  // that key and whether v was inserted.
+  std::pair<V *, bool> insert(V v) {
+    const std::string_view key = KeyOf{}(v);
+    const std::size_t hash = Hash{}(key);
+    if (const std::size_t i = find_index(key, hash); i != kNpos) return {&slots_[i].value, false};
+    if (growth_left_ == 0) grow();
+    const std::size_t i = find_first_non_full(hash);
+    growth_left_ -= ctrl_[i] == kEmpty;
+    set_ctrl(i, h2(hash));
+    Slot *s = std::construct_at(slots_ + i, hash, std::move(v));
+    ++size_;
+    return {&s->value, true};
+  }
+
+  bool erase(std::string_view key) {
+    const std::size_t i = find_index(key, Hash{}(key));
+    if (i == kNpos) return false;
+    std::destroy_at(slots_ + i);
+    set_ctrl(i, kDeleted);
+    --size_;
+    return true;
+  }
+
+  void clear() {
+    destroy();
+    ctrl_ = nullptr;
+    slots_ = nullptr;
+    capacity_ = size_ = growth_left_ = 0;
+  }
+
+  template <class F>
+  void for_each(F &&f) const {
+    for (std::size_t i = 0; i < capacity_; ++i) {
+      if (ctrl_[i] >= 0) f(slots_[i].value);
+    }
+  }
+
+private:
+  static constexpr std::size_t kNpos = ~std::size_t{0};
+
+  static std::size_t h1(std::size_t hash) { return hash >> 7; }
+  static ctrl_t h2(std::size_t hash) { return static_cast<ctrl_t>(hash & 0x7f); }
+  static std::size_t max_load(std::size_t cap) { return cap - cap / 8; }
+
+  std::size_t find_index(std::string_view key, std::size_t hash) const {
+    if (capacity_ == 0) return kNpos;
+    const std::size_t mask = capacity_ - 1;
+    std::size_t pos = h1(hash) & mask;
+    for (std::size_t step = kGroupWidth;; step += kGroupWidth) {
+      const Group g(ctrl_ + pos);
+      for (std::uint32_t m = g.match(h2(hash)); m; m &= m - 1) {
+        const std::size_t i = (pos + static_cast<std::size_t>(std::countr_zero(m))) & mask;
+        if (slots_[i].hash == hash && KeyOf{}(slots_[i].value) == key) return i;
+      }
+      if (g.match_empty()) return kNpos;
+      pos = (pos + step) & mask;
+    }
+  }
+
+  std::size_t find_first_non_full(std::size_t hash) const {
+    const std::size_t mask = capacity_ - 1;
+    std::size_t pos = h1(hash) & mask;
+    for (std::size_t step = kGroupWidth;; step += kGroupWidth) {
+      if (const std::uint32_t m = Group(ctrl_ + pos).match_empty_or_deleted())
+        return (pos + static_cast<std::size_t>(std::countr_zero(m))) & mask;
+      pos = (pos + step) & mask;
+    }
+  }
+
+  // The first kGroupWidth control bytes are mirrored past the end, so a group
+  // load starting anywhere in the table never wraps.
+  void set_ctrl(std::size_t i, ctrl_t c) {
+    ctrl_[i] = c;
+    if (i < kGroupWidth) ctrl_[capacity_ + i] = c;
+  }
+
+  // Out of growth budget: if tombstones ate it, rehash at the same size.
+  void grow() {
+    if (capacity_ > kGroupWidth && size_ * 32 <= capacity_ * 25) resize(capacity_);
+    else resize(capacity_ ? capacity_ * 2 : kGroupWidth);
+  }
+
+  void resize(std::size_t new_cap) {
+    ctrl_t *old_ctrl = ctrl_;
+    Slot *old_slots = slots_;
+    const std::size_t old_cap = capacity_;
+
+    ctrl_ = new ctrl_t[new_cap + kGroupWidth];
+    std::memset(ctrl_, kEmpty, new_cap + kGroupWidth);
+    slots_ = std::allocator<Slot>{}.allocate(new_cap);
+    capacity_ = new_cap;
+    growth_left_ = max_load(new_cap) - size_;
+
+    for (std::size_t i = 0; i < old_cap; ++i) {
+      if (old_ctrl[i] < 0) continue;
+      Slot &s = old_slots[i];
+      const std::size_t j = find_first_non_full(s.hash);
+      set_ctrl(j, h2(s.hash));
+      std::construct_at(slots_ + j, std::move(s));
+      std::destroy_at(&s);
+    }
+    if (old_cap) std::allocator<Slot>{}.deallocate(old_slots, old_cap);
+    delete[] old_ctrl;
+  }
+
+  void destroy() {
+    for (std::size_t i = 0; i < capacity_; ++i) {
+      if (ctrl_[i] >= 0) std::destroy_at(slots_ + i);
+    }
+    if (capacity_) std::allocator<Slot>{}.deallocate(slots_, capacity_);
+    delete[] ctrl_;
+  }
+
+  ctrl_t *ctrl_ = nullptr;
+  Slot *slots_ = nullptr;
+  std::size_t capacity_ = 0;
+  std::size_t size_ = 0;
+  std::size_t growth_left_ = 0;
+};
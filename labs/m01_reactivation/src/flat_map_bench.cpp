@@ -0,0 +1,153 @@
+// flat_map_bench.cpp — FlatHashMap vs std::unordered_map keyed by Payload strings
+// Build target: flat_map_bench
+//
+// Both maps hold n Payloads with distinct payload_key() strings. The flat map
+// keys on Payload::s in place; unordered_map<std::string, Payload> stores the
+// key a second time, as a lookup service keyed by string typically does.
+// Lookups and erases use a fixed random sample of keys so the access pattern
+// is cache-hostile at every size.
+
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "flat_hash_map.hpp"
+#include "payload.hpp"
+#include "perf_counters.hpp"
+
+struct PayloadKey {
+  std::string_view operator()(const Payload& p) const { return p.s; }
+};
+
+using FlatMap = FlatHashMap<Payload, PayloadKey>;
+using NodeMap = std::unordered_map<std::string, Payload>;
+
+constexpr std::size_t kMaxN = 1u << 22;
+constexpr std::size_t kProbes = 1u << 16; // keys looked up / erased per iteration
+
+static const std::vector<std::string>& keys() {
+  static const std::vector<std::string> k = [] {
+    std::vector<std::string> v;
+    v.reserve(kMaxN);
+    for (std::size_t i = 0; i < kMaxN; ++i) v.push_back(payload_key(i));
+    return v;
+  }();
+  return k;
+}
+
+static const std::vector<std::string>& miss_keys() {
+  static const std::vector<std::string> k = [] {
+    std::vector<std::string> v;
+    v.reserve(kProbes);
+    for (std::size_t i = 0; i < kProbes; ++i) v.push_back(payload_key(i, 1));
+    return v;
+  }();
+  return k;
+}
+
+// kProbes distinct indices in [0, n), shuffled (all of [0, n) when n is smaller).
+static std::vector<std::size_t> probe_order(std::size_t n) {
+  std::vector<std::size_t> idx(n);
+  for (std::size_t i = 0; i < n; ++i) idx[i] = i;
+  std::mt19937_64 rng(42);
+  std::shuffle(idx.begin(), idx.end(), rng);
+  idx.resize(std::min(n, kProbes));
+  return idx;
+}
+
+static void put(FlatMap& m, const std::string& k) { m.insert(Payload(k)); }
+static void put(NodeMap& m, const std::string& k) { m.try_emplace(k, k); }
+
+static const Payload* get(const FlatMap& m, const std::string& k) { return m.find(k); }
+static const Payload* get(const NodeMap& m, const std::string& k) {
+  const auto it = m.find(k);
+  return it == m.end() ? nullptr : &it->second;
+}
+
+template <class Map>
+static std::unique_ptr<Map> build(std::size_t n) {
+  auto m = std::make_unique<Map>();
+  const auto& k = keys();
+  for (std::size_t i = 0; i < n; ++i) put(*m, k[i]);
+  return m;
+}
+
+// Insert n records into an empty map, growth included. Each record is
+// constructed from its key (one string copy), the same for both maps.
+template <class Map>
+static void BM_Insert(benchmark::State& st) {
+  const std::size_t n = static_cast<std::size_t>(st.range(0));
+  const auto& k = keys();
+  for (auto _ : perfc::counted(st)) {
+    auto m = std::make_unique<Map>();
+    for (std::size_t i = 0; i < n; ++i) put(*m, k[i]);
+    benchmark::DoNotOptimize(m->size());
+    perfc::pause_timing(st);
+    m.reset(); // teardown is not part of insert
+    perfc::resume_timing(st);
+  }
+  st.SetItemsProcessed(static_cast<int64_t>(st.iterations() * n));
+}
+
+template <class Map>
+static void BM_LookupHit(benchmark::State& st) {
+  const std::size_t n = static_cast<std::size_t>(st.range(0));
+  const auto m = build<Map>(n);
+  const auto order = probe_order(n);
+  const auto& k = keys();
+  for (auto _ : perfc::counted(st)) {
+    for (std::size_t i : order) benchmark::DoNotOptimize(get(*m, k[i]));
+  }
+  st.SetItemsProcessed(static_cast<int64_t>(st.iterations() * order.size()));
+}
+
+template <class Map>
+static void BM_LookupMiss(benchmark::State& st) {
+  const std::size_t n = static_cast<std::size_t>(st.range(0));
+  const auto m = build<Map>(n);
+  const auto& k = miss_keys();
+  for (auto _ : perfc::counted(st)) {
+    for (const auto& key : k) benchmark::DoNotOptimize(get(*m, key));
+  }
+  st.SetItemsProcessed(static_cast<int64_t>(st.iterations() * k.size()));
+}
+
+// Erase a random sample; the records are put back untimed so every
+// iteration erases from a full map. Only the erases are timed: each leaves a
+// tombstone in the flat map, and the put-back refills tombstones or empty
+// slots (find_first_non_full takes either). Any cleanup rehash therefore
+// happens in the untimed put-back, if at all, since erase never rehashes.
+template <class Map>
+static void BM_Erase(benchmark::State& st) {
+  const std::size_t n = static_cast<std::size_t>(st.range(0));
+  const auto m = build<Map>(n);
+  const auto order = probe_order(n);
+  const auto& k = keys();
+  for (auto _ : perfc::counted(st)) {
+    for (std::size_t i : order) benchmark::DoNotOptimize(m->erase(k[i]));
+    perfc::pause_timing(st);
+    for (std::size_t i : order) put(*m, k[i]);
+    perfc::resume_timing(st);
+  }
+  st.SetItemsProcessed(static_cast<int64_t>(st.iterations() * order.size()));
+}
+
+#define MAP_ARGS RangeMultiplier(4)->Range(1 << 10, kMaxN)->ArgName("n")
+
+BENCHMARK_TEMPLATE(BM_Insert, FlatMap)->MAP_ARGS;
+BENCHMARK_TEMPLATE(BM_Insert, NodeMap)->MAP_ARGS;
+BENCHMARK_TEMPLATE(BM_LookupHit, FlatMap)->MAP_ARGS;
+BENCHMARK_TEMPLATE(BM_LookupHit, NodeMap)->MAP_ARGS;
+BENCHMARK_TEMPLATE(BM_LookupMiss, FlatMap)->MAP_ARGS;
+BENCHMARK_TEMPLATE(BM_LookupMiss, NodeMap)->MAP_ARGS;
+BENCHMARK_TEMPLATE(BM_Erase, FlatMap)->MAP_ARGS;
+BENCHMARK_TEMPLATE(BM_Erase, NodeMap)->MAP_ARGS;
+
+BENCHMARK_MAIN();
@@ -0,0 +1,84 @@
+// format_bench.cpp — Producing records: make_payload + emplace_back vs text written into a TextArena
+// Build target: format_bench
+//
+// Each iteration is one batch cycle: release the previous batch, then
+// produce n records into a vector reserved up front. The Payload paths
+// allocate one string per record and free n strings on release; the arena
+// paths write the same text into 1 MiB chunks kept from the previous batch,
+// store a PayloadView, and release by resetting the arena. Both halves are
+// timed: freeing n strings costs about as much as formatting them.
+
+#include <benchmark/benchmark.h>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "payload.hpp"
+#include "perf_counters.hpp"
+#include "text_arena.hpp"
+
+static void BM_MakePayload_EmplaceBack(benchmark::State& st) {
+  const std::size_t n = static_cast<std::size_t>(st.range(0));
+  std::vector<Payload> v;
+  v.reserve(n);
+  for (auto _ : perfc::counted(st)) {
+    v.clear();
+    for (std::size_t i = 0; i < n; ++i) v.emplace_back(make_payload(i));
+    benchmark::DoNotOptimize(v.data());
+    benchmark::ClobberMemory();
+  }
+  st.SetItemsProcessed(static_cast<int64_t>(st.iterations() * n));
+}
+
+static void BM_PayloadView_Arena(benchmark::State& st) {
+  const std::size_t n = static_cast<std::size_t>(st.range(0));
+  std::vector<PayloadView> v;
+  v.reserve(n);
+  TextArena arena(n * 32);
+  for (auto _ : perfc::counted(st)) {
+    v.clear();
+    arena.clear();
+    for (std::size_t i = 0; i < n; ++i) v.push_back(make_payload_view(i, arena));
+    benchmark::DoNotOptimize(v.data());
+    benchmark::ClobberMemory();
+  }
+  st.SetItemsProcessed(static_cast<int64_t>(st.iterations() * n));
+}
+
+// Formatted text (prefix + 16 hex digits) rather than a fill.
+static void BM_KeyedPayload_EmplaceBack(benchmark::State& st) {
+  const std::size_t n = static_cast<std::size_t>(st.range(0));
+  std::vector<Payload> v;
+  v.reserve(n);
+  for (auto _ : perfc::counted(st)) {
+    v.clear();
+    for (std::size_t i = 0; i < n; ++i) v.emplace_back(payload_key(i));
+    benchmark::DoNotOptimize(v.data());
+    benchmark::ClobberMemory();
+  }
+  st.SetItemsProcessed(static_cast<int64_t>(st.iterations() * n));
+}
+
+static void BM_KeyedView_Arena(benchmark::State& st) {
+  const std::size_t n = static_cast<std::size_t>(st.range(0));
+  std::vector<PayloadView> v;
+  v.reserve(n);
+  TextArena arena(n * 32);
+  for (auto _ : perfc::counted(st)) {
+    v.clear();
+    arena.clear();
+    for (std::size_t i = 0; i < n; ++i) v.push_back(make_keyed_view(i, arena));
+    benchmark::DoNotOptimize(v.data());
+    benchmark::ClobberMemory();
+  }
+  st.SetItemsProcessed(static_cast<int64_t>(st.iterations() * n));
+}
+
+#define FORMAT_ARGS Arg(1 << 14)->Arg(1 << 20)->ArgName("n")
+
+BENCHMARK(BM_MakePayload_EmplaceBack)->FORMAT_ARGS;
+BENCHMARK(BM_PayloadView_Arena)->FORMAT_ARGS;
+BENCHMARK(BM_KeyedPayload_EmplaceBack)->FORMAT_ARGS;
+BENCHMARK(BM_KeyedView_Arena)->FORMAT_ARGS;
+
+BENCHMARK_MAIN();
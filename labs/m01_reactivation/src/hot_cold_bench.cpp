@@ -0,0 +1,138 @@
+// hot_cold_bench.cpp — std::vector<Payload> vs PayloadColumns (hot key column + cold buf column)
+// Build target: hot_cold_bench
+//
+// Same records in both layouts: payload_key(i) keys, buf filled with i.
+// ScanKeys reads only the key, ScanBufs only the payload ints; Copy
+// duplicates the whole store (and frees the copy); MoveEach moves record by
+// record into a reserved store, as BM_MovePushBack does in bench_copy_move.
+
+#include <benchmark/benchmark.h>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "payload.hpp"
+#include "payload_columns.hpp"
+#include "perf_counters.hpp"
+
+using Rows = std::vector<Payload>;
+
+static Payload record(std::size_t i) {
+  Payload p(payload_key(i));
+  p.buf.fill(static_cast<int>(i));
+  return p;
+}
+
+static Rows make_rows(std::size_t n) {
+  Rows v;
+  v.reserve(n);
+  for (std::size_t i = 0; i < n; ++i) v.push_back(record(i));
+  return v;
+}
+
+static PayloadColumns make_columns(std::size_t n) {
+  PayloadColumns c;
+  c.reserve(n);
+  for (std::size_t i = 0; i < n; ++i) c.push_back(record(i));
+  return c;
+}
+
+// The filter: does the key's first random digit fall in 0-7 (about half)?
+static bool keep(const std::string& s) { return s[16] < '8'; }
+
+NOINLINE std::size_t scan_keys(const Rows& v) {
+  std::size_t hits = 0;
+  for (const Payload& p : v) hits += keep(p.s);
+  return hits;
+}
+NOINLINE std::size_t scan_keys(const PayloadColumns& c) {
+  std::size_t hits = 0;
+  for (const std::string& s : c.keys()) hits += keep(s);
+  return hits;
+}
+
+NOINLINE std::int64_t scan_bufs(const Rows& v) {
+  std::int64_t sum = 0;
+  for (const Payload& p : v) sum += p.buf[0] + p.buf[15];
+  return sum;
+}
+NOINLINE std::int64_t scan_bufs(const PayloadColumns& c) {
+  std::int64_t sum = 0;
+  for (const auto& b : c.bufs()) sum += b[0] + b[15];
+  return sum;
+}
+
+template <class Store>
+static Store make_store(std::size_t n) {
+  if constexpr (std::is_same_v<Store, Rows>) {
+    return make_rows(n);
+  } else {
+    return make_columns(n);
+  }
+}
+
+template <class Store>
+static void BM_ScanKeys(benchmark::State& st) {
+  const std::size_t n = static_cast<std::size_t>(st.range(0));
+  const Store s = make_store<Store>(n);
+  for (auto _ : perfc::counted(st)) benchmark::DoNotOptimize(scan_keys(s));
+  st.SetItemsProcessed(static_cast<int64_t>(st.iterations() * n));
+}
+
+template <class Store>
+static void BM_ScanBufs(benchmark::State& st) {
+  const std::size_t n = static_cast<std::size_t>(st.range(0));
+  const Store s = make_store<Store>(n);
+  for (auto _ : perfc::counted(st)) benchmark::DoNotOptimize(scan_bufs(s));
+  st.SetItemsProcessed(static_cast<int64_t>(st.iterations() * n));
+}
+
+template <class Store>
+static void BM_Copy(benchmark::State& st) {
+  const std::size_t n = static_cast<std::size_t>(st.range(0));
+  const Store src = make_store<Store>(n);
+  for (auto _ : perfc::counted(st)) {
+    Store dst = src;
+    benchmark::DoNotOptimize(&dst);
+  }
+  st.SetItemsProcessed(static_cast<int64_t>(st.iterations() * n));
+}
+
+static void move_one(Rows& dst, Rows& src, std::size_t i) { dst.push_back(std::move(src[i])); }
+static void move_one(PayloadColumns& dst, PayloadColumns& src, std::size_t i) {
+  dst.emplace_back(std::move(src.key(i)), src.buf(i));
+}
+
+template <class Store>
+static void BM_MoveEach(benchmark::State& st) {
+  const std::size_t n = static_cast<std::size_t>(st.range(0));
+  for (auto _ : perfc::counted(st)) {
+    perfc::pause_timing(st);
+    Store src = make_store<Store>(n);
+    Store dst;
+    dst.reserve(n);
+    perfc::resume_timing(st);
+    for (std::size_t i = 0; i < n; ++i) move_one(dst, src, i);
+    benchmark::DoNotOptimize(&dst);
+    benchmark::ClobberMemory();
+    perfc::pause_timing(st);
+    { Store gone = std::move(dst), gone_src = std::move(src); }
+    perfc::resume_timing(st);
+  }
+  st.SetItemsProcessed(static_cast<int64_t>(st.iterations() * n));
+}
+
+#define LAYOUT_ARGS Arg(1 << 10)->Arg(1 << 14)->Arg(1 << 20)
+
+BENCHMARK_TEMPLATE(BM_ScanKeys, Rows)->LAYOUT_ARGS;
+BENCHMARK_TEMPLATE(BM_ScanKeys, PayloadColumns)->LAYOUT_ARGS;
+BENCHMARK_TEMPLATE(BM_ScanBufs, Rows)->LAYOUT_ARGS;
+BENCHMARK_TEMPLATE(BM_ScanBufs, PayloadColumns)->LAYOUT_ARGS;
+BENCHMARK_TEMPLATE(BM_Copy, Rows)->LAYOUT_ARGS;
+BENCHMARK_TEMPLATE(BM_Copy, PayloadColumns)->LAYOUT_ARGS;
+BENCHMARK_TEMPLATE(BM_MoveEach, Rows)->LAYOUT_ARGS;
+BENCHMARK_TEMPLATE(BM_MoveEach, PayloadColumns)->LAYOUT_ARGS;
+
+BENCHMARK_MAIN();
@@ -0,0 +1,69 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "text_arena.hpp"
+
+#if defined(__clang__) || defined(__GNUC__)
+  #define NOINLINE [[gnu::noinline]]
+#elif defined(_MSC_VER)
+  #define NOINLINE __declspec(noinline)
+#else
+  #define NOINLINE
+#endif
+
+// The record every m01 benchmark moves around: a heap-allocated 32-char
+// string next to 64 bytes of inline data (96 bytes with libstdc++).
+struct Payload {
+  std::string s;
+  std::array<int, 16> buf{};
+  Payload() = default;
+  explicit Payload(std::string v) : s(std::move(v)) {}
+  Payload(const Payload&) = default;
+  Payload& operator=(const Payload&) = default;
+  Payload(Payload&&) noexcept = default;
+  Payload& operator=(Payload&&) noexcept = default;
+  ~Payload() = default;
+};
+
+NOINLINE inline Payload make_payload(std::size_t i) {
+  return Payload(std::string(32, static_cast<char>('a' + (i % 23))));
+}
+
+// Distinct 32-char key for record i: a fixed prefix and i scrambled into 16
+// hex digits, so neighbouring records do not share long prefixes or sort in
+// insertion order. `space` selects a disjoint key set (e.g. 1 for misses).
+inline void put_payload_key(TextWriter& w, std::uint64_t i, unsigned space = 0) {
+  std::uint64_t x = i + 0x9e3779b97f4a7c15ull * (space + 1);
+  x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+  x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+  x ^= x >> 31;
+  w.put("payload:record:/").put_hex(x, 16);
+}
+
+inline std::string payload_key(std::uint64_t i, unsigned space = 0) {
+  std::string k(32, '\0');
+  TextWriter w(k.data(), k.size());
+  put_payload_key(w, i, space);
+  return k;
+}
+
+// Record whose text lives in a TextArena: no allocation per record, and
+// 80 bytes instead of Payload's 96 plus a heap block.
+struct PayloadView {
+  std::string_view s;
+  std::array<int, 16> buf{};
+};
+
+// Same text as make_payload(i), written into the arena.
+inline PayloadView make_payload_view(std::size_t i, TextArena& arena) {
+  return {arena.format(32, [i](TextWriter& w) { w.put(static_cast<char>('a' + (i % 23)), 32); })};
+}
+
+inline PayloadView make_keyed_view(std::uint64_t i, TextArena& arena) {
+  return {arena.format(32, [i](TextWriter& w) { put_payload_key(w, i); })};
+}
@@ -0,0 +1,55 @@
+#pragma once
+#include <cstddef>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "payload.hpp"
+
+// Payload split by access frequency: the hot key column (32-byte std::string
+// objects, two per cache line) and the cold buf column (64 bytes each), both
+// addressed by the same index. Only the string headers are dense: keys past
+// the 15-char SSO limit (payload_key's are 32) live in their own heap blocks,
+// so a key scan still dereferences one block per record in either layout.
+// What the split saves is the stride between headers, 32 bytes instead of a
+// 96-byte Payload. A buf column is trivially copyable, so whole-store copies
+// of it are one memcpy.
+class PayloadColumns {
+public:
+  using Buf = decltype(Payload::buf);
+
+  PayloadColumns() = default;
+
+  void reserve(std::size_t n) {
+    s_.reserve(n);
+    buf_.reserve(n);
+  }
+  std::size_t size() const { return s_.size(); }
+
+  void emplace_back(std::string s, const Buf& buf = {}) {
+    s_.push_back(std::move(s));
+    buf_.push_back(buf);
+  }
+  void push_back(const Payload& p) { emplace_back(p.s, p.buf); }
+  void push_back(Payload&& p) { emplace_back(std::move(p.s), p.buf); }
+
+  std::string& key(std::size_t i) { return s_[i]; }
+  const std::string& key(std::size_t i) const { return s_[i]; }
+  Buf& buf(std::size_t i) { return buf_[i]; }
+  const Buf& buf(std::size_t i) const { return buf_[i]; }
+
+  std::span<const std::string> keys() const { return s_; }
+  std::span<const Buf> bufs() const { return buf_; }
+
+  // Reassembles record i (a copy), for code that wants the row form.
+  Payload row(std::size_t i) const {
+    Payload p(s_[i]);
+    p.buf = buf_[i];
+    return p;
+  }
+
+private:
+  std::vector<std::string> s_;
+  std::vector<Buf> buf_;
+};
@@ -0,0 +1,280 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "work_stealing_pool.hpp" // m05: WorkStealingPool, TaskGroup, parallel_for
+
+// MSD radix sort for records keyed by a string (e.g. Payload by Payload::s).
+//
+// The records are not touched while sorting. A 16-byte entry per record
+// {8 key bytes at the current depth (big-endian), record index, key length}
+// is radix-sorted one byte per level into 256 buckets. Each range first ORs
+// together how its chunks differ from the first one, so bytes shared by the
+// whole range are skipped: a long common prefix costs one pass per 8 bytes,
+// not one per byte. When a range agrees on all 8 bytes, keys that end inside
+// them go first (shortest first: each is a prefix of the next) and the rest
+// reload their next 8 bytes. Ranges under kSmallSort entries finish with
+// std::sort. The records are then moved into place once: cycle by cycle in
+// place (serial), or gathered into a new vector by all workers (parallel).
+//
+// The parallel version runs the same algorithm on a WorkStealingPool: large
+// ranges split their passes (scan, reload, count, scatter) into blocks, and
+// large buckets are forked as tasks. Not stable: records with equal keys end
+// up in unspecified order. Entries hold 32-bit indices and lengths, so inputs
+// of 2^32 or more records, or with a key of 4 GiB or more, are handed to
+// std::sort instead.
+namespace radix {
+
+struct Entry {
+  std::uint64_t chunk; // key bytes [depth, depth + 8), zero-padded, big-endian
+  std::uint32_t idx;   // record index
+  std::uint32_t len;   // key length
+};
+static_assert(sizeof(Entry) == 16);
+
+inline std::uint64_t load_chunk(std::string_view s, std::size_t depth) {
+  std::uint64_t w = 0;
+  if (depth + 8 <= s.size()) {
+    std::memcpy(&w, s.data() + depth, 8);
+  } else if (depth < s.size()) {
+    std::memcpy(&w, s.data() + depth, s.size() - depth);
+  }
+  if constexpr (std::endian::native == std::endian::little) w = __builtin_bswap64(w);
+  return w;
+}
+
+namespace detail {
+
+constexpr std::size_t kSmallSort = 64;      // std::sort below this
+constexpr std::size_t kParLevel = 1u << 17; // split a range's passes into blocks above this
+constexpr std::size_t kForkMin = 1u << 12;  // fork buckets at least this large
+constexpr std::size_t kBlock = 1u << 15;    // entries per block in a split pass
+
+struct NoPool {};
+
+using Hist = std::array<std::size_t, 256>;
+
+template <class T, class KeyOf, class Pool>
+class Sorter {
+  static constexpr bool kParallel = !std::is_same_v<Pool, NoPool>;
+  using Group = TaskGroup<Pool>; // only instantiated when kParallel
+
+public:
+  Sorter(const T *recs, KeyOf key, Pool *pool) : recs_(recs), key_(key), pool_(pool) {}
+
+  // a holds chunks at depth 0; tmp is scratch of the same size.
+  void sort(Entry *a, Entry *tmp, std::size_t n) {
+    if constexpr (kParallel) {
+      Group g(*pool_);
+      sort_range(a, tmp, n, 0, &g);
+      g.wait();
+    } else {
+      sort_range(a, tmp, n, 0, nullptr);
+    }
+  }
+
+  // body(begin, end, block) over [0, n) in kBlock pieces, on the pool when n is large.
+  template <class F>
+  void blocks(std::size_t n, const F &body) {
+    const std::size_t nb = (n + kBlock - 1) / kBlock;
+    if constexpr (kParallel) {
+      if (n >= kParLevel) {
+        parallel_for(*pool_, 0, nb, 1, [&](std::size_t b) { body(b * kBlock, std::min(n, (b + 1) * kBlock), b); });
+        return;
+      }
+    }
+    for (std::size_t b = 0; b < nb; ++b) body(b * kBlock, std::min(n, (b + 1) * kBlock), b);
+  }
+
+private:
+  std::string_view key(const Entry &e) const { return key_(recs_[e.idx]); }
+
+  // Entries whose chunks agree so far; depth is where their chunks start.
+  void sort_range(Entry *a, Entry *tmp, std::size_t n, std::size_t depth, Group *g) {
+    for (;;) {
+      if (n < kSmallSort) return small_sort(a, n, depth);
+
+      std::uint64_t diff = 0;
+      const std::uint64_t first = a[0].chunk;
+      if (kParallel && n >= kParLevel) {
+        std::vector<std::uint64_t> part((n + kBlock - 1) / kBlock, 0);
+        blocks(n, [&](std::size_t b, std::size_t e, std::size_t blk) {
+          std::uint64_t d = 0;
+          for (std::size_t i = b; i < e; ++i) d |= a[i].chunk ^ first;
+          part[blk] = d;
+        });
+        for (std::uint64_t d : part) diff |= d;
+      } else {
+        for (std::size_t i = 1; i < n; ++i) diff |= a[i].chunk ^ first;
+      }
+      if (diff != 0) return distribute(a, tmp, n, depth, 56 - (std::countl_zero(diff) & ~7), g);
+
+      // Whole chunk equal: keys ending inside it go first, by length; the
+      // rest load their next 8 bytes and continue.
+      Entry *mid = std::partition(a, a + n, [depth](const Entry &e) { return e.len <= depth + 8; });
+      std::sort(a, mid, [](const Entry &x, const Entry &y) { return x.len < y.len; });
+      const std::size_t skipped = static_cast<std::size_t>(mid - a);
+      a = mid;
+      tmp += skipped;
+      n -= skipped;
+      depth += 8;
+      blocks(n, [&](std::size_t b, std::size_t e, std::size_t) {
+        for (std::size_t i = b; i < e; ++i) a[i].chunk = load_chunk(key(a[i]), depth);
+      });
+    }
+  }
+
+  // One level on byte (chunk >> shift) & 0xff; every bucket then continues
+  // in sort_range, as a task when the pool is in use and it is large.
+  void distribute(Entry *a, Entry *tmp, std::size_t n, std::size_t depth, int shift, Group *g) {
+    const auto byte = [shift](const Entry &e) { return static_cast<std::size_t>((e.chunk >> shift) & 0xff); };
+    Hist count{};
+    if (kParallel && n >= kParLevel) {
+      const std::size_t nb = (n + kBlock - 1) / kBlock;
+      std::vector<Hist> pos(nb, Hist{});
+      blocks(n, [&](std::size_t b, std::size_t e, std::size_t blk) {
+        for (std::size_t i = b; i < e; ++i) ++pos[blk][byte(a[i])];
+      });
+      // Block blk writes bucket k after all smaller buckets and after
+      // bucket k's entries from earlier blocks.
+      std::size_t off = 0;
+      for (std::size_t k = 0; k < 256; ++k) {
+        for (std::size_t blk = 0; blk < nb; ++blk) {
+          const std::size_t c = pos[blk][k];
+          pos[blk][k] = off;
+          off += c;
+          count[k] += c;
+        }
+      }
+      blocks(n, [&](std::size_t b, std::size_t e, std::size_t blk) {
+        Hist &p = pos[blk];
+        for (std::size_t i = b; i < e; ++i) tmp[p[byte(a[i])]++] = a[i];
+      });
+      blocks(n, [&](std::size_t b, std::size_t e, std::size_t) {
+        std::memcpy(a + b, tmp + b, (e - b) * sizeof(Entry));
+      });
+    } else {
+      for (std::size_t i = 0; i < n; ++i) ++count[byte(a[i])];
+      Hist pos;
+      std::size_t off = 0;
+      for (std::size_t k = 0; k < 256; ++k) {
+        pos[k] = off;
+        off += count[k];
+      }
+      for (std::size_t i = 0; i < n; ++i) tmp[pos[byte(a[i])]++] = a[i];
+      std::memcpy(a, tmp, n * sizeof(Entry));
+    }
+
+    std::size_t begin = 0;
+    for (std::size_t k = 0; k < 256; ++k) {
+      const std::size_t c = count[k];
+      Entry *ba = a + begin, *bt = tmp + begin;
+      begin += c;
+      if (c < 2) continue;
+      if constexpr (kParallel) {
+        if (c >= kForkMin) {
+          g->run([this, ba, bt, c, depth, g] { sort_range(ba, bt, c, depth, g); });
+          continue;
+        }
+      }
+      sort_range(ba, bt, c, depth, g);
+    }
+  }
+
+  // Chunks first; ties (equal chunk) compare the rest of the key.
+  void small_sort(Entry *a, std::size_t n, std::size_t depth) {
+    std::sort(a, a + n, [this, depth](const Entry &x, const Entry &y) {
+      if (x.chunk != y.chunk) return x.chunk < y.chunk;
+      const std::string_view kx = key(x), ky = key(y);
+      return kx.substr(std::min(depth, kx.size())) < ky.substr(std::min(depth, ky.size()));
+    });
+  }
+
+  const T *recs_;
+  KeyOf key_;
+  Pool *pool_;
+};
+
+constexpr std::size_t kMaxEntry = UINT32_MAX; // largest index or length an Entry holds
+
+template <class T, class KeyOf>
+void fallback_sort(std::vector<T> &v, KeyOf &key) {
+  std::sort(v.begin(), v.end(), [&key](const T &x, const T &y) { return key(x) < key(y); });
+}
+
+template <class T, class KeyOf, class Pool>
+void sort(std::vector<T> &v, KeyOf key, Pool *pool) {
+  const std::size_t n = v.size();
+  if (n < 2) return;
+  if (n > kMaxEntry) {
+    fallback_sort(v, key);
+    return;
+  }
+  auto a = std::make_unique_for_overwrite<Entry[]>(n);
+  auto tmp = std::make_unique_for_overwrite<Entry[]>(n);
+  Sorter<T, KeyOf, Pool> s(v.data(), key, pool);
+  std::atomic<bool> too_long{false};
+  s.blocks(n, [&](std::size_t b, std::size_t e, std::size_t) {
+    for (std::size_t i = b; i < e; ++i) {
+      const std::string_view k = key(v[i]);
+      if (k.size() > kMaxEntry) [[unlikely]] too_long.store(true, std::memory_order_relaxed);
+      a[i] = Entry{load_chunk(k, 0), static_cast<std::uint32_t>(i), static_cast<std::uint32_t>(k.size())};
+    }
+  });
+  if (too_long.load(std::memory_order_relaxed)) {
+    fallback_sort(v, key);
+    return;
+  }
+  s.sort(a.get(), tmp.get(), n);
+
+  if constexpr (std::is_same_v<Pool, NoPool>) {
+    // Follow each cycle of the permutation once; a[i].idx == i marks done.
+    for (std::size_t i = 0; i < n; ++i) {
+      if (a[i].idx == i) continue;
+      T hold = std::move(v[i]);
+      std::size_t j = i;
+      for (;;) {
+        const std::size_t from = a[j].idx;
+        a[j].idx = static_cast<std::uint32_t>(j);
+        if (from == i) {
+          v[j] = std::move(hold);
+          break;
+        }
+        v[j] = std::move(v[from]);
+        j = from;
+      }
+    }
+  } else {
+    std::vector<T> out(n);
+    s.blocks(n, [&](std::size_t b, std::size_t e, std::size_t) {
+      for (std::size_t i = b; i < e; ++i) out[i] = std::move(v[a[i].idx]);
+    });
+    v.swap(out);
+  }
+}
+
+} // namespace detail
+
+// Sorts v by key(record) (a string_view), on the calling thread.
+template <class T, class KeyOf>
+void sort(std::vector<T> &v, KeyOf key) {
+  detail::sort<T, KeyOf, detail::NoPool>(v, key, nullptr);
+}
+
+// Same result, with the work spread over pool's workers (the caller helps).
+template <class T, class KeyOf, class Pool>
+void sort(std::vector<T> &v, KeyOf key, Pool &pool) {
+  detail::sort<T, KeyOf, Pool>(v, key, &pool);
+}
+
+} // namespace radix
@@ -0,0 +1,104 @@
+// radix_sort_bench.cpp — Sorting std::vector<Payload> by s: MSD radix vs std::sort / std::stable_sort
+// Build target: radix_sort_bench
+//
+// Keys are payload_key(i): 32 chars, a 16-char prefix shared by every record,
+// then 16 random hex digits. Each iteration sorts the same shuffled input
+// (rebuilt untimed); the first sorted result is checked with is_sorted.
+
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "payload.hpp"
+#include "perf_counters.hpp"
+#include "radix_sort.hpp"
+
+static std::string_view payload_s(const Payload& p) { return p.s; }
+
+static std::vector<Payload> make_input(std::size_t n) {
+  std::vector<Payload> v;
+  v.reserve(n);
+  for (std::size_t i = 0; i < n; ++i) v.emplace_back(payload_key(i));
+  return v;
+}
+
+// Puts v back into the same pseudo-random order whatever order it is in now.
+static void reshuffle(std::vector<Payload>& v) {
+  std::sort(v.begin(), v.end(), [](const Payload& a, const Payload& b) { return a.s < b.s; });
+  std::mt19937_64 rng(7);
+  std::shuffle(v.begin(), v.end(), rng);
+}
+
+template <class SortFn>
+static void run_sort(benchmark::State& st, SortFn sort) {
+  const std::size_t n = static_cast<std::size_t>(st.range(0));
+  auto v = make_input(n);
+  reshuffle(v);
+  bool checked = false;
+  for (auto _ : perfc::counted(st)) {
+    sort(v);
+    benchmark::ClobberMemory();
+    perfc::pause_timing(st);
+    if (!checked) {
+      checked = true;
+      if (!std::is_sorted(v.begin(), v.end(), [](const Payload& a, const Payload& b) { return a.s < b.s; })) {
+        st.SkipWithError("output not sorted");
+        break;
+      }
+    }
+    reshuffle(v);
+    perfc::resume_timing(st);
+  }
+  st.SetItemsProcessed(static_cast<int64_t>(st.iterations() * n));
+}
+
+static void BM_StdSort(benchmark::State& st) {
+  run_sort(st, [](std::vector<Payload>& v) {
+    std::sort(v.begin(), v.end(), [](const Payload& a, const Payload& b) { return a.s < b.s; });
+  });
+}
+
+static void BM_StdStableSort(benchmark::State& st) {
+  run_sort(st, [](std::vector<Payload>& v) {
+    std::stable_sort(v.begin(), v.end(), [](const Payload& a, const Payload& b) { return a.s < b.s; });
+  });
+}
+
+static void BM_RadixSort(benchmark::State& st) {
+  run_sort(st, [](std::vector<Payload>& v) { radix::sort(v, payload_s); });
+}
+
+// Arg(1) = pool threads; the calling thread helps while it waits.
+static void BM_RadixSortParallel(benchmark::State& st) {
+  WorkStealingPool pool(static_cast<unsigned>(st.range(1)));
+  run_sort(st, [&pool](std::vector<Payload>& v) { radix::sort(v, payload_s, pool); });
+}
+
+// 2^24 records take ~2.3 GB per copy of the vector; sort needs up to two.
+#define SORT_ARGS RangeMultiplier(4)->Range(1 << 16, 1 << 24)->ArgName("n")->Unit(benchmark::kMillisecond)->UseRealTime()
+
+BENCHMARK(BM_StdSort)->SORT_ARGS;
+BENCHMARK(BM_StdStableSort)->SORT_ARGS;
+BENCHMARK(BM_RadixSort)->SORT_ARGS;
+
+// Sizes x powers of two up to the core count, plus the core count itself.
+static void SizesByThreads(benchmark::internal::Benchmark* b) {
+  const unsigned hw = std::thread::hardware_concurrency() ? std::thread::hardware_concurrency() : 1;
+  for (std::int64_t n = 1 << 16; n <= 1 << 24; n *= 4) {
+    for (unsigned t = 1; t < hw; t *= 2) b->Args({n, t});
+    b->Args({n, hw});
+  }
+}
+BENCHMARK(BM_RadixSortParallel)
+    ->Apply(SizesByThreads)
+    ->ArgNames({"n", "threads"})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+BENCHMARK_MAIN();
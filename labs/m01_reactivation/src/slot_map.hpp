@@ -0,0 +1,103 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <utility>
+#include <vector>
+
+// Slot map: stable generational handles over a dense, contiguous array.
+//
+//   slots_   handle.index -> {dense position, generation}   (never shrinks)
+//   values_  the records, packed: iteration is a plain array walk
+//   owner_   dense position -> slot index, to patch the slot of the record
+//            that moves when another is erased
+//
+// insert appends to values_ and takes a slot from the free list; erase moves
+// the last record into the hole and frees the slot: both O(1), no search.
+// A slot's generation is odd while it is occupied and is bumped on insert
+// and on erase, so a handle to an erased record (even one whose slot was
+// reused) no longer matches and get() returns nullptr. Iteration order is
+// not insertion order: erase reorders. Generations wrap after 2^31 reuses
+// of one slot.
+template <class T>
+class SlotMap {
+public:
+  struct Handle {
+    std::uint32_t index = 0;
+    std::uint32_t generation = 0; // 0 never matches: a default Handle is invalid
+    bool operator==(const Handle&) const = default;
+  };
+
+  void reserve(std::size_t n) {
+    slots_.reserve(n);
+    values_.reserve(n);
+    owner_.reserve(n);
+  }
+  std::size_t size() const { return values_.size(); }
+  bool empty() const { return values_.empty(); }
+
+  Handle insert(T v) {
+    std::uint32_t s;
+    if (free_head_ != kNone) {
+      s = free_head_;
+      free_head_ = slots_[s].pos;
+    } else {
+      s = static_cast<std::uint32_t>(slots_.size());
+      slots_.push_back(Slot{});
+    }
+    Slot& slot = slots_[s];
+    slot.pos = static_cast<std::uint32_t>(values_.size());
+    ++slot.generation;
+    values_.push_back(std::move(v));
+    owner_.push_back(s);
+    return {s, slot.generation};
+  }
+
+  bool erase(Handle h) {
+    if (!contains(h)) return false;
+    Slot& slot = slots_[h.index];
+    const std::uint32_t pos = slot.pos;
+    const std::uint32_t last = static_cast<std::uint32_t>(values_.size() - 1);
+    if (pos != last) {
+      values_[pos] = std::move(values_[last]);
+      owner_[pos] = owner_[last];
+      slots_[owner_[pos]].pos = pos;
+    }
+    values_.pop_back();
+    owner_.pop_back();
+    ++slot.generation;
+    slot.pos = free_head_;
+    free_head_ = h.index;
+    return true;
+  }
+
+  bool contains(Handle h) const {
+    return h.index < slots_.size() && slots_[h.index].generation == h.generation && (h.generation & 1);
+  }
+  T* get(Handle h) { return contains(h) ? &values_[slots_[h.index].pos] : nullptr; }
+  const T* get(Handle h) const { return contains(h) ? &values_[slots_[h.index].pos] : nullptr; }
+
+  // Dense iteration over the live records.
+  auto begin() { return values_.begin(); }
+  auto end() { return values_.end(); }
+  auto begin() const { return values_.begin(); }
+  auto end() const { return values_.end(); }
+  std::span<T> values() { return values_; }
+  std::span<const T> values() const { return values_; }
+
+  // Handle of the record at dense position i (e.g. while iterating).
+  Handle handle_at(std::size_t i) const { return {owner_[i], slots_[owner_[i]].generation}; }
+
+private:
+  static constexpr std::uint32_t kNone = ~std::uint32_t{0};
+
+  struct Slot {
+    std::uint32_t pos = kNone;     // dense position if occupied, else next free slot
+    std::uint32_t generation = 0;  // odd while occupied
+  };
+
+  std::vector<Slot> slots_;
+  std::vector<T> values_;
+  std::vector<std::uint32_t> owner_;
+  std::uint32_t free_head_ = kNone;
+};
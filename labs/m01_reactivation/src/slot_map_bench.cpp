@@ -0,0 +1,166 @@
+// slot_map_bench.cpp — SlotMap vs std::vector + erase-remove, std::list, std::unordered_map under churn
+// Build target: slot_map_bench
+//
+// Each store keeps n live Payloads and a way to name each one: a SlotMap
+// handle, a list iterator, a map key, or an id field for the vector. One
+// round erases a random pct% of the records by name, inserts as many new
+// ones, then walks every live record. The vector erases its whole batch
+// with one remove_if pass, the only way it keeps O(n) rounds.
+
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <numeric>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+#include "payload.hpp"
+#include "perf_counters.hpp"
+#include "slot_map.hpp"
+
+using Victims = std::vector<std::uint32_t>; // positions in [0, n) to replace this round
+
+static std::int64_t visit(const Payload& p) { return p.buf[0] + static_cast<std::int64_t>(p.s.size()); }
+
+struct SlotMapStore {
+  SlotMap<Payload> m;
+  std::vector<SlotMap<Payload>::Handle> live;
+
+  explicit SlotMapStore(std::size_t n) {
+    m.reserve(n);
+    for (std::size_t i = 0; i < n; ++i) live.push_back(m.insert(make_payload(i)));
+  }
+  void churn(const Victims& vs, std::size_t serial) {
+    for (std::uint32_t k : vs) m.erase(live[k]);
+    for (std::uint32_t k : vs) live[k] = m.insert(make_payload(serial++));
+  }
+  std::int64_t iterate() const {
+    std::int64_t sum = 0;
+    for (const Payload& p : m) sum += visit(p);
+    return sum;
+  }
+};
+
+struct ListStore {
+  std::list<Payload> l;
+  std::vector<std::list<Payload>::iterator> live;
+
+  explicit ListStore(std::size_t n) {
+    for (std::size_t i = 0; i < n; ++i) live.push_back(l.insert(l.end(), make_payload(i)));
+  }
+  void churn(const Victims& vs, std::size_t serial) {
+    for (std::uint32_t k : vs) l.erase(live[k]);
+    for (std::uint32_t k : vs) live[k] = l.insert(l.end(), make_payload(serial++));
+  }
+  std::int64_t iterate() const {
+    std::int64_t sum = 0;
+    for (const Payload& p : l) sum += visit(p);
+    return sum;
+  }
+};
+
+// Keyed by position in [0, n): a replaced record takes over its victim's key.
+struct MapStore {
+  std::unordered_map<std::uint32_t, Payload> m;
+
+  explicit MapStore(std::size_t n) {
+    m.reserve(n);
+    for (std::size_t i = 0; i < n; ++i) m.emplace(static_cast<std::uint32_t>(i), make_payload(i));
+  }
+  void churn(const Victims& vs, std::size_t serial) {
+    for (std::uint32_t k : vs) m.erase(k);
+    for (std::uint32_t k : vs) m.emplace(k, make_payload(serial++));
+  }
+  std::int64_t iterate() const {
+    std::int64_t sum = 0;
+    for (const auto& [k, p] : m) sum += visit(p);
+    return sum;
+  }
+};
+
+// Records carry their id; a batch is flagged, then dropped in one remove_if.
+struct VectorStore {
+  struct Rec {
+    std::uint32_t id;
+    Payload p;
+  };
+  std::vector<Rec> v;
+  std::vector<char> dead;
+
+  explicit VectorStore(std::size_t n) : dead(n, 0) {
+    v.reserve(n);
+    for (std::size_t i = 0; i < n; ++i) v.push_back({static_cast<std::uint32_t>(i), make_payload(i)});
+  }
+  void churn(const Victims& vs, std::size_t serial) {
+    for (std::uint32_t k : vs) dead[k] = 1;
+    v.erase(std::remove_if(v.begin(), v.end(), [this](const Rec& r) { return dead[r.id] != 0; }), v.end());
+    for (std::uint32_t k : vs) {
+      dead[k] = 0;
+      v.push_back({k, make_payload(serial++)});
+    }
+  }
+  std::int64_t iterate() const {
+    std::int64_t sum = 0;
+    for (const Rec& r : v) sum += visit(r.p);
+    return sum;
+  }
+};
+
+// A few rounds' worth of distinct random victims, reused cyclically.
+static std::vector<Victims> make_rounds(std::size_t n, std::size_t per_round) {
+  std::vector<Victims> rounds(8);
+  std::mt19937 rng(11);
+  Victims all(n);
+  std::iota(all.begin(), all.end(), 0u);
+  for (auto& r : rounds) {
+    std::shuffle(all.begin(), all.end(), rng);
+    r.assign(all.begin(), all.begin() + static_cast<std::ptrdiff_t>(per_round));
+  }
+  return rounds;
+}
+
+// Arg(live records, percent replaced per round)
+template <class Store>
+static void BM_Mixed(benchmark::State& st) {
+  const std::size_t n = static_cast<std::size_t>(st.range(0));
+  const std::size_t per_round = std::max<std::size_t>(1, n * static_cast<std::size_t>(st.range(1)) / 100);
+  const auto rounds = make_rounds(n, per_round);
+  Store s(n);
+  std::size_t serial = n, r = 0;
+  for (auto _ : perfc::counted(st)) {
+    s.churn(rounds[r++ % rounds.size()], serial);
+    serial += per_round;
+    benchmark::DoNotOptimize(s.iterate());
+  }
+  // erases + inserts + records visited
+  st.SetItemsProcessed(static_cast<int64_t>(st.iterations() * (2 * per_round + n)));
+}
+
+// Iteration alone, after 16 rounds of 25% churn have shuffled the store.
+template <class Store>
+static void BM_Iterate(benchmark::State& st) {
+  const std::size_t n = static_cast<std::size_t>(st.range(0));
+  const auto rounds = make_rounds(n, n / 4);
+  Store s(n);
+  std::size_t serial = n;
+  for (int i = 0; i < 16; ++i, serial += n / 4) s.churn(rounds[static_cast<std::size_t>(i) % rounds.size()], serial);
+  for (auto _ : perfc::counted(st)) benchmark::DoNotOptimize(s.iterate());
+  st.SetItemsProcessed(static_cast<int64_t>(st.iterations() * n));
+}
+
+#define MIXED_ARGS ArgsProduct({{1 << 10, 1 << 14, 1 << 18}, {1, 10, 50}})->ArgNames({"n", "pct"})
+#define ITER_ARGS Arg(1 << 10)->Arg(1 << 14)->Arg(1 << 18)->ArgName("n")
+
+BENCHMARK_TEMPLATE(BM_Mixed, SlotMapStore)->MIXED_ARGS;
+BENCHMARK_TEMPLATE(BM_Mixed, VectorStore)->MIXED_ARGS;
+BENCHMARK_TEMPLATE(BM_Mixed, ListStore)->MIXED_ARGS;
+BENCHMARK_TEMPLATE(BM_Mixed, MapStore)->MIXED_ARGS;
+BENCHMARK_TEMPLATE(BM_Iterate, SlotMapStore)->ITER_ARGS;
+BENCHMARK_TEMPLATE(BM_Iterate, VectorStore)->ITER_ARGS;
+BENCHMARK_TEMPLATE(BM_Iterate, ListStore)->ITER_ARGS;
+BENCHMARK_TEMPLATE(BM_Iterate, MapStore)->ITER_ARGS;
+
+BENCHMARK_MAIN();
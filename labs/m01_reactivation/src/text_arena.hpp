@@ -0,0 +1,137 @@
+#pragma once
+#include <algorithm>
+#include <bit>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+// Bounded text sink in the style of std::format_to_n (which GCC 12 lacks):
+// writes into [p, end), drops whatever does not fit, and remembers that it
+// truncated. size() is what was actually written.
+class TextWriter {
+public:
+  TextWriter(char* out, std::size_t n) : begin_(out), p_(out), end_(out + n) {}
+
+  TextWriter& put(char c, std::size_t count = 1) {
+    const std::size_t k = room(count);
+    std::memset(p_, c, k);
+    p_ += k;
+    return *this;
+  }
+  TextWriter& put(std::string_view s) {
+    const std::size_t k = room(s.size());
+    std::memcpy(p_, s.data(), k);
+    p_ += k;
+    return *this;
+  }
+  TextWriter& put_uint(std::uint64_t v) {
+    char tmp[20];
+    const auto r = std::to_chars(tmp, tmp + sizeof(tmp), v);
+    return put(std::string_view(tmp, static_cast<std::size_t>(r.ptr - tmp)));
+  }
+  // Exactly `digits` lowercase hex digits of v's low bits, zero-padded.
+  // Eight digits per 64-bit word, no per-digit loop; the full 16 are stored
+  // straight into the window when they fit.
+  TextWriter& put_hex(std::uint64_t v, unsigned digits) {
+    digits = std::min(digits, 16u);
+    const std::uint64_t hex[2] = {hex8(static_cast<std::uint32_t>(v >> 32)), hex8(static_cast<std::uint32_t>(v))};
+    if (digits == 16 && static_cast<std::size_t>(end_ - p_) >= 16) {
+      std::memcpy(p_, hex, 16);
+      p_ += 16;
+      return *this;
+    }
+    char tmp[16];
+    std::memcpy(tmp, hex, 16);
+    return put(std::string_view(tmp + 16 - digits, digits));
+  }
+
+  std::size_t size() const { return static_cast<std::size_t>(p_ - begin_); }
+  bool truncated() const { return truncated_; }
+
+private:
+  // The 8 hex digits of v as ASCII bytes in memory order: spread one nibble
+  // per byte, then add '0', plus 'a' - '0' - 10 where the nibble is >= 10.
+  static std::uint64_t hex8(std::uint32_t v) {
+    std::uint64_t x = v;
+    x = (x | (x << 16)) & 0x0000ffff0000ffffull;
+    x = (x | (x << 8)) & 0x00ff00ff00ff00ffull;
+    x = (x | (x << 4)) & 0x0f0f0f0f0f0f0f0full; // nibble k in byte k
+    if constexpr (std::endian::native == std::endian::little) x = __builtin_bswap64(x);
+    const std::uint64_t letters = ((x + 0x0606060606060606ull) >> 4) & 0x0101010101010101ull;
+    return x + 0x3030303030303030ull + letters * ('a' - '0' - 10);
+  }
+
+  std::size_t room(std::size_t want) {
+    const std::size_t left = static_cast<std::size_t>(end_ - p_);
+    if (want > left) truncated_ = true;
+    return std::min(want, left);
+  }
+
+  char* begin_;
+  char* p_;
+  char* end_;
+  bool truncated_ = false;
+};
+
+// Append-only text storage in large chunks. format() hands a TextWriter a
+// contiguous window, keeps the bytes written and returns a view of them.
+// Views stay valid until clear(); chunks never move. clear() keeps the
+// chunks, so refilling an arena of the same size allocates nothing.
+class TextArena {
+public:
+  explicit TextArena(std::size_t reserve_bytes = 0, std::size_t chunk_bytes = std::size_t{1} << 20)
+      : chunk_bytes_(std::max<std::size_t>(chunk_bytes, 1)) {
+    for (std::size_t have = 0; have < reserve_bytes; have += chunk_bytes_) add_chunk(chunk_bytes_);
+  }
+
+  // Writes at most max_bytes via fill(TextWriter&); a record never spans chunks.
+  template <class F>
+  std::string_view format(std::size_t max_bytes, F&& fill) {
+    char* p = reserve(max_bytes);
+    TextWriter w(p, max_bytes);
+    fill(w);
+    off_ += w.size();
+    return {p, w.size()};
+  }
+
+  void clear() {
+    cur_ = 0;
+    off_ = 0;
+  }
+
+  std::size_t capacity() const {
+    std::size_t total = 0;
+    for (const auto& c : chunks_) total += c.size;
+    return total;
+  }
+
+private:
+  struct Chunk {
+    std::unique_ptr<char[]> data;
+    std::size_t size;
+  };
+
+  void add_chunk(std::size_t size) {
+    chunks_.push_back({std::make_unique_for_overwrite<char[]>(size), size});
+  }
+
+  // Room for n bytes at the write position, moving to the next chunk (or a
+  // new one) when the current one is too full.
+  char* reserve(std::size_t n) {
+    while (cur_ < chunks_.size() && chunks_[cur_].size - off_ < n) {
+      ++cur_;
+      off_ = 0;
+    }
+    if (cur_ == chunks_.size()) add_chunk(std::max(chunk_bytes_, n));
+    return chunks_[cur_].data.get() + off_;
+  }
+
+  std::vector<Chunk> chunks_;
+  std::size_t chunk_bytes_;
+  std::size_t cur_ = 0; // chunk being filled
+  std::size_t off_ = 0; // bytes used in it
+};
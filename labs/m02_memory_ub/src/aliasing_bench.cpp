@@ -5,6 +5,8 @@
 #include <cstddef>
 #include <cstdint>
 
+#include "perf_counters.hpp"
+
 #if defined(__clang__) || defined(__GNUC__)
   #define NOINLINE [[gnu::noinline]]
 #elif defined(_MSC_VER)
@@ -29,7 +31,7 @@ NOINLINE void bitcast_write(float* dst, std::uint32_t pattern) {
 static void BM_UnsafePunning(benchmark::State& st) {
   const std::size_t N = static_cast<std::size_t>(st.range(0));
   std::vector<float> a(N, 0.0f);
-  for (auto _ : st) {
+  for (auto _ : perfc::counted(st)) {
     for (std::size_t i = 0; i < N; ++i) {
       std::uint32_t p = 0x3f800000u + static_cast<std::uint32_t>(i & 7);
       unsafe_pun_write(&a[i], p);
@@ -43,7 +45,7 @@ BENCHMARK(BM_UnsafePunning)->Arg(1<<10)->Arg(1<<14);
 static void BM_MemcpyWrite(benchmark::State& st) {
   const std::size_t N = static_cast<std::size_t>(st.range(0));
   std::vector<float> a(N, 0.0f);
-  for (auto _ : st) {
+  for (auto _ : perfc::counted(st)) {
     for (std::size_t i = 0; i < N; ++i) {
       std::uint32_t p = 0x3f800000u + static_cast<std::uint32_t>(i & 7);
       memcpy_write(&a[i], p);
@@ -57,7 +59,7 @@ BENCHMARK(BM_MemcpyWrite)->Arg(1<<10)->Arg(1<<14);
 static void BM_BitCastWrite(benchmark::State& st) {
   const std::size_t N = static_cast<std::size_t>(st.range(0));
   std::vector<float> a(N, 0.0f);
-  for (auto _ : st) {
+  for (auto _ : perfc::counted(st)) {
     for (std::size_t i = 0; i < N; ++i) {
       std::uint32_t p = 0x3f800000u + static_cast<std::uint32_t>(i & 7);
       bitcast_write(&a[i], p);
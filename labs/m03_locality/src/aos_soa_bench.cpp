@@ -8,6 +8,8 @@
 #include <type_traits>
 #include <vector>
 
+#include "perf_counters.hpp"
+
 #if defined(__clang__) || defined(__GNUC__)
   #define NOINLINE [[gnu::noinline]]
 #elif defined(_MSC_VER)
@@ -112,7 +114,7 @@ static void BM_AoS_AXPY_X(benchmark::State& st) {
   init_aos(p);
   std::vector<float> a(N, 1.01f), b(N, 0.001f);
 
-  for (auto _ : st) {
+  for (auto _ : perfc::counted(st)) {
     if (B == 0) {
       kernel_aos_axpy_x(p.data(), a.data(), b.data(), N);
     } else {
@@ -133,7 +135,7 @@ static void BM_SoA_AXPY_X(benchmark::State& st) {
   init_soa(s);
   std::vector<float> a(N, 1.01f), b(N, 0.001f);
 
-  for (auto _ : st) {
+  for (auto _ : perfc::counted(st)) {
     if (B == 0) {
       kernel_soa_axpy_x(s.x.data(), a.data(), b.data(), N);
     } else {
@@ -151,7 +153,7 @@ static void BM_AoS_SumX(benchmark::State& st) {
   std::vector<P> p(N);
   init_aos(p);
   float out = 0.0f;
-  for (auto _ : st) {
+  for (auto _ : perfc::counted(st)) {
     out = kernel_aos_sum_x(p.data(), N);
     benchmark::DoNotOptimize(out);
   }
@@ -164,7 +166,7 @@ static void BM_SoA_SumX(benchmark::State& st) {
   SoA s(N);
   init_soa(s);
   float out = 0.0f;
-  for (auto _ : st) {
+  for (auto _ : perfc::counted(st)) {
     out = kernel_soa_sum_x(s.x.data(), N);
     benchmark::DoNotOptimize(out);
   }
@@ -5,6 +5,8 @@
 #include <vector>
 #include <new>      // hardware_destructive_interference_size
 
+#include "perf_counters.hpp"
+
 #if defined(__clang__) || defined(__GNUC__)
   #define NOINLINE [[gnu::noinline]]
 #elif defined(_MSC_VER)
@@ -64,7 +66,7 @@ static void BM_FalseSharing_Shared(benchmark::State& st) {
   const std::size_t total_iters = 64ull * 1024ull * 1024ull; // 64M increments total
   const std::size_t iters_per_thread = total_iters / static_cast<std::size_t>(threads);
 
-  for (auto _ : st) {
+  for (auto _ : perfc::counted(st)) {
     auto sum = run_false_sharing_trial<SharedSlot>(threads, iters_per_thread);
     benchmark::DoNotOptimize(sum);
     benchmark::ClobberMemory();
@@ -78,7 +80,7 @@ static void BM_FalseSharing_Padded(benchmark::State& st) {
   const std::size_t total_iters = 64ull * 1024ull * 1024ull;
   const std::size_t iters_per_thread = total_iters / static_cast<std::size_t>(threads);
 
-  for (auto _ : st) {
+  for (auto _ : perfc::counted(st)) {
     auto sum = run_false_sharing_trial<PaddedSlot>(threads, iters_per_thread);
     benchmark::DoNotOptimize(sum);
     benchmark::ClobberMemory();
@@ -6,6 +6,8 @@
 #include <type_traits>
 #include <vector>
 
+#include "perf_counters.hpp"
+
 #if defined(__clang__) || defined(__GNUC__)
   #define NOINLINE [[gnu::noinline]]
 #elif defined(_MSC_VER)
@@ -83,7 +85,7 @@ static void BM_Runtime_Dispatch(benchmark::State& st) {
   const int tile = static_cast<int>(st.range(1));
 
   std::vector<float> a(N, 1.01f), b(N, 0.001f), x(N, 0.5f);
-  for (auto _ : st) {
+  for (auto _ : perfc::counted(st)) {
     axpy_runtime_tile(a.data(), b.data(), x.data(), N, tile);
     benchmark::DoNotOptimize(x.data());
     benchmark::ClobberMemory();
@@ -97,7 +99,7 @@ static void BM_CompileTime_Dispatch(benchmark::State& st) {
   const int tile = static_cast<int>(st.range(1));
 
   std::vector<float> a(N, 1.01f), b(N, 0.001f), x(N, 0.5f);
-  for (auto _ : st) {
+  for (auto _ : perfc::counted(st)) {
     axpy_compile_time_dispatch(a.data(), b.data(), x.data(), N, tile);
     benchmark::DoNotOptimize(x.data());
     benchmark::ClobberMemory();
@@ -5,6 +5,8 @@
 #include <string>
 #include <vector>
 
+#include "perf_counters.hpp"
+
 #if defined(__clang__) || defined(__GNUC__)
   #define NOINLINE [[gnu::noinline]]
 #elif defined(_MSC_VER)
@@ -73,7 +75,7 @@ static void BM_Virtual_Dispatch(benchmark::State& st) {
   const std::size_t N = static_cast<std::size_t>(st.range(0));
   std::vector<float> x(N, 1.0f);
   MulAdd op; // dynamic polymorphism used via base ref
-  for (auto _ : st) {
+  for (auto _ : perfc::counted(st)) {
     float out = loop_virtual(static_cast<const Op&>(op), x.data(), N);
     benchmark::DoNotOptimize(out);
     benchmark::ClobberMemory();
@@ -86,7 +88,7 @@ static void BM_CRTP_Static(benchmark::State& st) {
   const std::size_t N = static_cast<std::size_t>(st.range(0));
   std::vector<float> x(N, 1.0f);
   MulAddC op; // static polymorphism
-  for (auto _ : st) {
+  for (auto _ : perfc::counted(st)) {
     float out = loop_crtp(op, x.data(), N);
     benchmark::DoNotOptimize(out);
     benchmark::ClobberMemory();
@@ -0,0 +1,23 @@
+#pragma once
+#include <thread>
+
+#if defined(__linux__)
+  #include <pthread.h>
+  #include <sched.h>
+#endif
+
+// Pin the calling thread to a CPU. The index wraps modulo the online CPU count so
+// benchmarks asking for "core 1" still run on single-core boxes and containers.
+// Returns false (and leaves the thread unpinned) when affinity is unsupported.
+inline bool pin_this_thread(unsigned cpu) {
+#if defined(__linux__)
+  const unsigned ncpu = std::thread::hardware_concurrency();
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  CPU_SET(ncpu ? cpu % ncpu : 0, &set);
+  return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+  (void)cpu;
+  return false;
+#endif
+}
@@ -0,0 +1,221 @@
+#include <benchmark/benchmark.h>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "backoff.hpp"
+#include "perf_counters.hpp"
+#include "spsc_ring.hpp"
+#include "thread_cache_pool.hpp"
+
+#if defined(__clang__) || defined(__GNUC__)
+  #define NOINLINE [[gnu::noinline]]
+#elif defined(_MSC_VER)
+  #define NOINLINE __declspec(noinline)
+#else
+  #define NOINLINE
+#endif
+
+// ---------------------------------------------------------------------------
+// Allocators under test, behind one static interface. Both the object and
+// its string buffer come from the same arena.
+// ---------------------------------------------------------------------------
+
+struct MallocArena {
+  static constexpr const char *name = "glibc_malloc";
+  template <class T>
+  using Allocator = std::allocator<T>;
+  static void *allocate(std::size_t n) {
+    if (void *p = std::malloc(n)) return p;
+    throw std::bad_alloc();
+  }
+  static void deallocate(void *p, std::size_t) noexcept { std::free(p); }
+};
+
+struct PoolArena {
+  static constexpr const char *name = "thread_cache_pool";
+  template <class T>
+  using Allocator = PoolAllocator<T>;
+  static void *allocate(std::size_t n) { return ThreadCachePool::allocate(n); }
+  static void deallocate(void *p, std::size_t n) noexcept { ThreadCachePool::deallocate(p, n); }
+};
+
+// Same shape as the m01 Payload: a 32-char string (heap buffer, past SSO)
+// plus 64 bytes of inline data, i.e. two allocations per object.
+template <class Arena>
+struct Payload {
+  using String = std::basic_string<char, std::char_traits<char>, typename Arena::template Allocator<char>>;
+  String s;
+  std::array<int, 16> buf{};
+  explicit Payload(std::size_t i) : s(32, static_cast<char>('a' + (i % 23))) { buf[0] = static_cast<int>(i); }
+};
+
+template <class Arena>
+NOINLINE Payload<Arena> *make_payload(std::size_t i) {
+  return new (Arena::allocate(sizeof(Payload<Arena>))) Payload<Arena>(i);
+}
+
+template <class Arena>
+NOINLINE void drop_payload(Payload<Arena> *p) {
+  p->~Payload();
+  Arena::deallocate(p, sizeof(Payload<Arena>));
+}
+
+constexpr std::size_t kOpsPerThread = 1u << 18;
+
+// Slow-path traffic of the pool (zero for malloc), per allocation.
+template <class Arena>
+static void report_pool_stats(benchmark::State &st, const ThreadCachePool::Stats &s0, double allocs) {
+  if constexpr (std::is_same_v<Arena, PoolArena>) {
+    const auto s1 = ThreadCachePool::stats();
+    st.counters["central_ops_per_alloc"] = static_cast<double>((s1.refills - s0.refills) + (s1.flushes - s0.flushes)) / allocs;
+  }
+  st.SetLabel(Arena::name);
+}
+
+// Runs body(tid) on `threads` threads released together; returns when all finish.
+template <class Body>
+static void run_threads(std::size_t threads, Body body) {
+  std::atomic<bool> start{false};
+  std::vector<std::thread> ts;
+  ts.reserve(threads);
+  for (std::size_t t = 0; t < threads; ++t) {
+    ts.emplace_back([&, t] {
+      SpinThenYield wait;
+      while (!start.load(std::memory_order_acquire)) wait();
+      body(t);
+    });
+  }
+  start.store(true, std::memory_order_release);
+  for (auto &t : ts) t.join();
+}
+
+// ---------------------------------------------------------------------------
+// Thread-local churn: each thread keeps a window of live Payloads and
+// replaces the oldest one per step (allocate and free on the same thread).
+// ---------------------------------------------------------------------------
+
+template <class Arena>
+static void BM_Alloc_Payload(benchmark::State &st) {
+  const auto threads = static_cast<std::size_t>(st.range(0));
+  constexpr std::size_t kLive = 256;
+  const auto s0 = ThreadCachePool::stats();
+  for (auto _ : perfc::counted(st)) {
+    run_threads(threads, [](std::size_t tid) {
+      std::array<Payload<Arena> *, kLive> live{};
+      for (std::size_t i = 0; i < kOpsPerThread; ++i) {
+        auto *&slot = live[i % kLive];
+        if (slot) drop_payload<Arena>(slot);
+        slot = make_payload<Arena>(i + tid);
+        benchmark::DoNotOptimize(slot->s.data());
+      }
+      for (auto *p : live) drop_payload<Arena>(p);
+    });
+  }
+  const double objects = static_cast<double>(st.iterations() * threads * kOpsPerThread);
+  st.SetItemsProcessed(static_cast<int64_t>(objects));
+  report_pool_stats<Arena>(st, s0, 2 * objects); // object + string buffer
+}
+
+// ---------------------------------------------------------------------------
+// Mixed sizes: 16..4096 bytes, skewed small (70% <= 128B, 25% <= 1KiB).
+// ---------------------------------------------------------------------------
+
+static std::size_t mixed_size(std::uint64_t &x) {
+  x ^= x << 13;
+  x ^= x >> 7;
+  x ^= x << 17;
+  const unsigned r = static_cast<unsigned>(x % 100);
+  const std::size_t lo = r < 70 ? 16 : r < 95 ? 129 : 1025;
+  const std::size_t hi = r < 70 ? 128 : r < 95 ? 1024 : 4096;
+  return lo + static_cast<std::size_t>((x >> 8) % (hi - lo + 1));
+}
+
+template <class Arena>
+static void BM_Alloc_Mixed(benchmark::State &st) {
+  const auto threads = static_cast<std::size_t>(st.range(0));
+  constexpr std::size_t kLive = 1024;
+  const auto s0 = ThreadCachePool::stats();
+  for (auto _ : perfc::counted(st)) {
+    run_threads(threads, [](std::size_t tid) {
+      struct Block {
+        void *p = nullptr;
+        std::size_t n = 0;
+      };
+      std::vector<Block> live(kLive);
+      std::uint64_t x = 0x9E3779B97F4A7C15ull * (tid + 1);
+      for (std::size_t i = 0; i < kOpsPerThread; ++i) {
+        Block &b = live[i % kLive];
+        Arena::deallocate(b.p, b.n);
+        b.n = mixed_size(x);
+        b.p = Arena::allocate(b.n);
+        static_cast<char *>(b.p)[0] = static_cast<char>(i); // touch it
+      }
+      for (auto &b : live) Arena::deallocate(b.p, b.n);
+    });
+  }
+  const double allocs = static_cast<double>(st.iterations() * threads * kOpsPerThread);
+  st.SetItemsProcessed(static_cast<int64_t>(allocs));
+  report_pool_stats<Arena>(st, s0, allocs);
+}
+
+// ---------------------------------------------------------------------------
+// Cross-thread free: Arg(pairs) producer/consumer pairs. The producer builds
+// Payloads and hands the pointers over an SpscRing; the consumer frees them.
+// Every block is freed on a different thread from the one that allocated it.
+// ---------------------------------------------------------------------------
+
+template <class Arena>
+static void BM_Alloc_CrossThread(benchmark::State &st) {
+  using Ring = SpscRing<Payload<Arena> *, 1024>;
+  const auto pairs = static_cast<std::size_t>(st.range(0));
+  const auto s0 = ThreadCachePool::stats();
+  for (auto _ : perfc::counted(st)) {
+    perfc::pause_timing(st);
+    std::vector<std::unique_ptr<Ring>> rings;
+    for (std::size_t p = 0; p < pairs; ++p) rings.push_back(std::make_unique<Ring>());
+    perfc::resume_timing(st);
+    run_threads(2 * pairs, [&rings](std::size_t tid) {
+      Ring &ring = *rings[tid / 2];
+      SpinThenYield wait;
+      if (tid % 2 == 0) {
+        for (std::size_t i = 0; i < kOpsPerThread; ++i) {
+          Payload<Arena> *p = make_payload<Arena>(i);
+          while (!ring.try_push(p)) wait();
+          wait.reset();
+        }
+      } else {
+        Payload<Arena> *p;
+        for (std::size_t i = 0; i < kOpsPerThread; ++i) {
+          while (!ring.try_pop(p)) wait();
+          wait.reset();
+          benchmark::DoNotOptimize(p->buf[0]);
+          drop_payload<Arena>(p);
+        }
+      }
+    });
+  }
+  const double objects = static_cast<double>(st.iterations() * pairs * kOpsPerThread);
+  st.SetItemsProcessed(static_cast<int64_t>(objects));
+  report_pool_stats<Arena>(st, s0, 2 * objects);
+}
+
+#define ALLOC_ARGS Arg(1)->Arg(2)->Arg(4)->Arg(8)->Arg(16)->ArgName("threads")->UseRealTime()
+#define CROSS_ARGS Arg(1)->Arg(2)->Arg(4)->Arg(8)->ArgName("pairs")->UseRealTime()
+
+BENCHMARK_TEMPLATE(BM_Alloc_Payload, MallocArena)->ALLOC_ARGS;
+BENCHMARK_TEMPLATE(BM_Alloc_Payload, PoolArena)->ALLOC_ARGS;
+BENCHMARK_TEMPLATE(BM_Alloc_Mixed, MallocArena)->ALLOC_ARGS;
+BENCHMARK_TEMPLATE(BM_Alloc_Mixed, PoolArena)->ALLOC_ARGS;
+BENCHMARK_TEMPLATE(BM_Alloc_CrossThread, MallocArena)->CROSS_ARGS;
+BENCHMARK_TEMPLATE(BM_Alloc_CrossThread, PoolArena)->CROSS_ARGS;
+
+BENCHMARK_MAIN();
@@ -0,0 +1,112 @@
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <concepts>
+#include <thread>
+
+#if defined(__x86_64__) || defined(__i386__)
+  #include <immintrin.h>
+#endif
+
+inline void cpu_relax() {
+#if defined(__x86_64__) || defined(__i386__)
+  _mm_pause();
+#endif
+}
+
+// A backoff policy is called once per failed attempt of a spin loop and reset
+// after progress:
+//
+//   B wait;
+//   while (!ring.try_pop(v)) wait();
+//
+// Policies trade wake-up latency against the CPU burned (and the sibling
+// hyperthread / other runnable threads starved) while waiting.
+template <class B>
+concept Backoff = std::default_initializable<B> && requires(B b) {
+  b();
+  b.reset();
+  { B::name } -> std::convertible_to<const char *>;
+};
+
+// Re-poll immediately. Lowest latency on a dedicated core; hammers the shared
+// line and the sibling hyperthread, and livelocks on an oversubscribed CPU.
+struct SpinBackoff {
+  static constexpr const char *name = "spin";
+  void operator()() {}
+  void reset() {}
+};
+
+// One PAUSE per poll: tells the core it is spinning (saves power, yields
+// pipeline resources to the sibling, avoids the memory-order mis-speculation
+// flush on loop exit). ~40-140 cycles depending on microarchitecture.
+struct PauseBackoff {
+  static constexpr const char *name = "pause";
+  void operator()() { cpu_relax(); }
+  void reset() {}
+};
+
+// Doubling runs of PAUSE up to a cap: quick reaction to short waits, fewer
+// coherence requests on the contended line during long ones.
+struct ExpPauseBackoff {
+  static constexpr const char *name = "exp_pause";
+  static constexpr unsigned kMaxPauses = 1024;
+  unsigned pauses = 1;
+  void operator()() {
+    for (unsigned i = 0; i < pauses; ++i) cpu_relax();
+    pauses = std::min(pauses * 2, kMaxPauses);
+  }
+  void reset() { pauses = 1; }
+};
+
+// Give the rest of the time slice away on every poll: a syscall per attempt,
+// but the only pure policy that stays sane when threads outnumber cores.
+struct YieldBackoff {
+  static constexpr const char *name = "yield";
+  void operator()() { std::this_thread::yield(); }
+  void reset() {}
+};
+
+// Bounded spin before yielding: on pinned, dedicated cores the yield never fires,
+// but oversubscribed runs (CI, laptops) still make progress.
+struct SpinThenYield {
+  static constexpr const char *name = "spin_then_yield";
+  unsigned spins = 0;
+  void operator()() {
+    if (++spins < 1024) {
+      cpu_relax();
+    } else {
+      spins = 0;
+      std::this_thread::yield();
+    }
+  }
+  void reset() { spins = 0; }
+};
+
+// Spin briefly, then park the thread with short sleeps that double up to 1ms.
+// Near-zero CPU while idle, at the price of up to a park period of added
+// latency on wake-up (there is no notifier: the waiter re-polls after each nap).
+struct SpinThenPark {
+  static constexpr const char *name = "spin_then_park";
+  static constexpr unsigned kSpins = 4096;
+  static constexpr std::chrono::microseconds kFirstPark{50};
+  static constexpr std::chrono::microseconds kMaxPark{1000};
+  unsigned spins = 0;
+  std::chrono::microseconds park = kFirstPark;
+  void operator()() {
+    if (spins < kSpins) {
+      ++spins;
+      cpu_relax();
+      return;
+    }
+    std::this_thread::sleep_for(park);
+    park = std::min(park * 2, kMaxPark);
+  }
+  void reset() {
+    spins = 0;
+    park = kFirstPark;
+  }
+};
+
+static_assert(Backoff<SpinBackoff> && Backoff<PauseBackoff> && Backoff<ExpPauseBackoff> && Backoff<YieldBackoff> &&
+              Backoff<SpinThenYield> && Backoff<SpinThenPark>);
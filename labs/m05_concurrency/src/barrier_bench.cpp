@@ -0,0 +1,82 @@
+#include <benchmark/benchmark.h>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "barriers.hpp"
+#include "latency_histogram.hpp"
+#include "perf_counters.hpp"
+
+#if defined(__clang__) || defined(__GNUC__)
+  #define NOINLINE [[gnu::noinline]]
+#elif defined(_MSC_VER)
+  #define NOINLINE __declspec(noinline)
+#else
+  #define NOINLINE
+#endif
+
+constexpr std::size_t kEpisodes = 1u << 12;
+
+// Each thread runs kEpisodes back-to-back barrier episodes with no work in
+// between, so the measured time is pure synchronization cost. Thread 0 times
+// every episode (exit to exit) into a histogram; the iteration time is the
+// whole sequence as seen by thread 0 (manual timing excludes thread start-up).
+template <class Barrier>
+NOINLINE void barrier_worker(Barrier *b, std::size_t tid, std::size_t threads, std::uint64_t *phase_check,
+                             std::atomic<std::uint64_t> *early, LatencyHistogram<> *hist, double *elapsed) {
+  using clock = std::chrono::steady_clock;
+  b->arrive_and_wait(tid); // warm-up: everyone has started
+  auto prev = clock::now();
+  const auto t0 = prev;
+  for (std::size_t e = 0; e < kEpisodes; ++e) {
+    // Cheap correctness probe: once released from episode e, the next thread
+    // must have announced e too, or the barrier let us out early.
+    std::atomic_ref<std::uint64_t>(phase_check[tid]).store(e + 1, std::memory_order_relaxed);
+    b->arrive_and_wait(tid);
+    const std::size_t next = (tid + 1) % threads;
+    if (std::atomic_ref<std::uint64_t>(phase_check[next]).load(std::memory_order_relaxed) < e + 1) {
+      early->fetch_add(1, std::memory_order_relaxed);
+    }
+    if (tid == 0) {
+      const auto now = clock::now();
+      hist->record(static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(now - prev).count()));
+      prev = now;
+    }
+  }
+  if (tid == 0) *elapsed = std::chrono::duration<double>(clock::now() - t0).count();
+}
+
+template <class Barrier>
+static void BM_Barrier(benchmark::State &st) {
+  const auto threads = static_cast<std::size_t>(st.range(0));
+  LatencyHistogram<> hist;
+  for (auto _ : perfc::counted(st)) {
+    Barrier b(threads);
+    std::vector<std::uint64_t> phase(threads, 0);
+    std::atomic<std::uint64_t> early{0};
+    double elapsed = 0;
+    std::vector<std::thread> ts;
+    ts.reserve(threads);
+    for (std::size_t t = 0; t < threads; ++t) {
+      ts.emplace_back(barrier_worker<Barrier>, &b, t, threads, phase.data(), &early, &hist, &elapsed);
+    }
+    for (auto &t : ts) t.join();
+    if (early.load() != 0) st.SkipWithError("a thread left the barrier before its neighbour arrived");
+    st.SetIterationTime(elapsed);
+  }
+  st.SetItemsProcessed(static_cast<int64_t>(st.iterations() * kEpisodes));
+  report_latency(st, hist);
+  st.SetLabel(Barrier::name);
+}
+
+#define BARRIER_ARGS RangeMultiplier(2)->Range(2, 64)->ArgName("threads")->UseManualTime()
+
+BENCHMARK_TEMPLATE(BM_Barrier, CentralBarrier<>)->BARRIER_ARGS;
+BENCHMARK_TEMPLATE(BM_Barrier, DisseminationBarrier<>)->BARRIER_ARGS;
+BENCHMARK_TEMPLATE(BM_Barrier, TournamentBarrier<>)->BARRIER_ARGS;
+BENCHMARK_TEMPLATE(BM_Barrier, StdBarrier)->BARRIER_ARGS;
+
+BENCHMARK_MAIN();
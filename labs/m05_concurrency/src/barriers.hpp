@@ -0,0 +1,156 @@
+#pragma once
+#include <atomic>
+#include <barrier>
+#include <bit>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "backoff.hpp"
+#include "cache_line.hpp"
+
+// Reusable barriers for a fixed team of n threads with ids 0..n-1, following
+// Mellor-Crummey & Scott, "Algorithms for Scalable Synchronization on
+// Shared-Memory Multiprocessors" (TOCS'91). All share one interface:
+//
+//   barrier.arrive_and_wait(tid);
+//
+// and every spin goes through a Backoff policy. Sense reversal lets the same
+// flags be reused episode after episode without a reset pass.
+
+namespace barrier_detail {
+struct alignas(kCacheLine) Flag {
+  std::atomic<bool> v{false};
+};
+struct alignas(kCacheLine) Sense {
+  bool v = true; // thread-private
+};
+
+inline unsigned ceil_log2(std::size_t n) { return n <= 1 ? 0u : static_cast<unsigned>(std::bit_width(n - 1)); }
+
+template <class B>
+inline void wait_for(const std::atomic<bool> &flag, bool value) {
+  B backoff;
+  while (flag.load(std::memory_order_acquire) != value) backoff();
+}
+} // namespace barrier_detail
+
+// Centralized sense-reversing barrier: one fetch_sub per arrival on a shared
+// counter, then everybody spins on one global sense flag. O(n) serialized RMWs
+// on the counter line per episode, and the release invalidates n spinners.
+template <Backoff B = SpinThenYield>
+class CentralBarrier {
+public:
+  explicit CentralBarrier(std::size_t n) : n_(static_cast<int>(n)), count_(static_cast<int>(n)), local_(n) {}
+
+  void arrive_and_wait(std::size_t tid) {
+    const bool sense = local_[tid].v;
+    local_[tid].v = !sense;
+    if (count_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      count_.store(n_, std::memory_order_relaxed);
+      sense_.store(sense, std::memory_order_release);
+    } else {
+      barrier_detail::wait_for<B>(sense_, sense);
+    }
+  }
+
+  static constexpr const char *name = "central_sense_reversing";
+
+private:
+  const int n_;
+  alignas(kCacheLine) std::atomic<int> count_;
+  alignas(kCacheLine) std::atomic<bool> sense_{false};
+  std::vector<barrier_detail::Sense> local_;
+};
+
+// Dissemination barrier (Hensgen, Finkel & Manber): ceil(log2 n) rounds; in
+// round r thread i signals thread (i + 2^r) mod n and waits for its own flag.
+// No RMWs and no hot spot, but n*log n flag writes per episode. Two flag sets
+// alternate by parity so a fast thread cannot overwrite a flag still in use.
+template <Backoff B = SpinThenYield>
+class DisseminationBarrier {
+public:
+  explicit DisseminationBarrier(std::size_t n)
+      : n_(n), rounds_(barrier_detail::ceil_log2(n)), flags_(n * 2 * rounds_), local_(n) {}
+
+  void arrive_and_wait(std::size_t tid) {
+    Local &me = local_[tid];
+    for (unsigned r = 0; r < rounds_; ++r) {
+      const std::size_t partner = (tid + (std::size_t{1} << r)) % n_;
+      flag(partner, me.parity, r).store(me.sense, std::memory_order_release);
+      barrier_detail::wait_for<B>(flag(tid, me.parity, r), me.sense);
+    }
+    if (me.parity == 1) me.sense = !me.sense;
+    me.parity ^= 1;
+  }
+
+  static constexpr const char *name = "dissemination";
+
+private:
+  struct alignas(kCacheLine) Local {
+    unsigned parity = 0;
+    bool sense = true;
+  };
+
+  std::atomic<bool> &flag(std::size_t tid, unsigned parity, unsigned round) {
+    return flags_[(tid * 2 + parity) * rounds_ + round].v;
+  }
+
+  std::size_t n_;
+  unsigned rounds_;
+  std::vector<barrier_detail::Flag> flags_;
+  std::vector<Local> local_;
+};
+
+// Static tournament barrier: in round k the thread with id % 2^(k+1) == 0
+// (the winner) waits for its partner id + 2^k (the loser) to arrive; losers
+// drop out and wait to be woken. Thread 0 wins every round, then the wake-up
+// retraces the tree: each thread releases the losers it beat, in reverse order.
+// Every flag has exactly one writer and one spinner, so spinning stays local.
+template <Backoff B = SpinThenYield>
+class TournamentBarrier {
+public:
+  explicit TournamentBarrier(std::size_t n)
+      : n_(n), rounds_(barrier_detail::ceil_log2(n)), arrive_(n * (rounds_ ? rounds_ : 1)), wake_(n), local_(n) {}
+
+  void arrive_and_wait(std::size_t tid) {
+    const bool sense = local_[tid].v;
+    unsigned level = rounds_; // rounds this thread won (all of them for thread 0)
+    for (unsigned k = 0; k < rounds_; ++k) {
+      const std::size_t step = std::size_t{1} << k;
+      if (tid % (step * 2) == 0) {
+        if (tid + step < n_) barrier_detail::wait_for<B>(arrive_[tid * rounds_ + k].v, sense);
+      } else {
+        arrive_[(tid - step) * rounds_ + k].v.store(sense, std::memory_order_release);
+        barrier_detail::wait_for<B>(wake_[tid].v, sense);
+        level = k;
+        break;
+      }
+    }
+    for (unsigned k = level; k-- > 0;) {
+      const std::size_t partner = tid + (std::size_t{1} << k);
+      if (partner < n_) wake_[partner].v.store(sense, std::memory_order_release);
+    }
+    local_[tid].v = !sense;
+  }
+
+  static constexpr const char *name = "tournament";
+
+private:
+  std::size_t n_;
+  unsigned rounds_;
+  std::vector<barrier_detail::Flag> arrive_;
+  std::vector<barrier_detail::Flag> wake_;
+  std::vector<barrier_detail::Sense> local_;
+};
+
+// std::barrier behind the same interface (the library picks its own waiting).
+class StdBarrier {
+public:
+  explicit StdBarrier(std::size_t n) : b_(static_cast<std::ptrdiff_t>(n)) {}
+  void arrive_and_wait(std::size_t) { b_.arrive_and_wait(); }
+  static constexpr const char *name = "std_barrier";
+
+private:
+  std::barrier<> b_;
+};
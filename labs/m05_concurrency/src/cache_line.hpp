@@ -0,0 +1,8 @@
+#pragma once
+#include <cstddef>
+
+// Cache-line size for padding in headers. The .cpp benchmarks use
+// std::hardware_destructive_interference_size directly, but that value may
+// change with -march/-mtune, so anything shared between translation units
+// uses a fixed constant to keep layouts ABI-stable (GCC -Winterference-size).
+inline constexpr std::size_t kCacheLine = 64;
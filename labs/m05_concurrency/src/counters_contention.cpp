@@ -1,10 +1,15 @@
 #include <benchmark/benchmark.h>
 #include <atomic>
+#include <chrono>
 #include <cstddef>
 #include <cstdint>
 #include <thread>
 #include <vector>
 
+#include "backoff.hpp"
+#include "perf_counters.hpp"
+#include "trace.hpp"
+
 #if defined(__clang__) || defined(__GNUC__)
   #define NOINLINE [[gnu::noinline]]
 #elif defined(_MSC_VER)
@@ -26,12 +31,14 @@ static void BM_SharedAtomicCounter(benchmark::State& st) {
   const std::size_t total_increments = 64ull * 1024ull * 1024ull; // 64M
   const std::size_t iters_per_thread = total_increments / static_cast<std::size_t>(threads);
 
-  for (auto _ : st) {
+  for (auto _ : perfc::counted(st)) {
     std::atomic<std::uint64_t> shared{0};
     std::vector<std::thread> ts;
     ts.reserve(static_cast<std::size_t>(threads));
     for (int t = 0; t < threads; ++t) {
       ts.emplace_back([&shared, iters_per_thread]() {
+        TRACE_THREAD_NAME("writer");
+        TRACE_SCOPE("fetch_add_loop");
         for (std::size_t i = 0; i < iters_per_thread; ++i) {
           // Single contended cache line
           shared.fetch_add(1, std::memory_order_relaxed);
@@ -46,6 +53,57 @@ static void BM_SharedAtomicCounter(benchmark::State& st) {
 }
 BENCHMARK(BM_SharedAtomicCounter)->Arg(2)->Arg(4)->Arg(8);
 
+// CAS-loop increment on the shared counter, generic over the backoff policy
+// applied after each failed compare-exchange. Backing off spreads retries out
+// in time so fewer of them fail; too much backoff leaves the line idle.
+template <Backoff B>
+static void BM_CasCounter(benchmark::State& st) {
+  const int threads = static_cast<int>(st.range(0));
+  const std::size_t total_increments = 16ull * 1024ull * 1024ull; // 16M: CAS loops are slower
+  const std::size_t iters_per_thread = total_increments / static_cast<std::size_t>(threads);
+
+  for (auto _ : perfc::counted(st)) {
+    std::atomic<std::uint64_t> shared{0};
+    std::atomic<std::uint64_t> failures{0};
+    std::vector<std::thread> ts;
+    ts.reserve(static_cast<std::size_t>(threads));
+    for (int t = 0; t < threads; ++t) {
+      ts.emplace_back([&shared, &failures, iters_per_thread]() {
+        TRACE_THREAD_NAME("writer");
+        TRACE_SCOPE("cas_loop");
+        B backoff;
+        std::uint64_t failed = 0;
+        for (std::size_t i = 0; i < iters_per_thread; ++i) {
+          std::uint64_t cur = shared.load(std::memory_order_relaxed);
+          if (!shared.compare_exchange_weak(cur, cur + 1, std::memory_order_relaxed)) {
+            // Span from the first failure to the eventual success
+            TRACE_BEGIN("cas_retry");
+            do {
+              ++failed;
+              backoff();
+            } while (!shared.compare_exchange_weak(cur, cur + 1, std::memory_order_relaxed));
+            TRACE_END("cas_retry");
+          }
+          backoff.reset();
+        }
+        failures.fetch_add(failed, std::memory_order_relaxed);
+      });
+    }
+    for (auto& th : ts) th.join();
+    benchmark::DoNotOptimize(shared.load(std::memory_order_relaxed));
+    st.counters["cas_fail_per_inc"] =
+        static_cast<double>(failures.load()) / static_cast<double>(iters_per_thread * static_cast<std::size_t>(threads));
+    benchmark::ClobberMemory();
+  }
+  st.SetLabel(B::name);
+}
+BENCHMARK_TEMPLATE(BM_CasCounter, SpinBackoff)->Arg(2)->Arg(4)->Arg(8)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_CasCounter, PauseBackoff)->Arg(2)->Arg(4)->Arg(8)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_CasCounter, ExpPauseBackoff)->Arg(2)->Arg(4)->Arg(8)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_CasCounter, YieldBackoff)->Arg(2)->Arg(4)->Arg(8)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_CasCounter, SpinThenYield)->Arg(2)->Arg(4)->Arg(8)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_CasCounter, SpinThenPark)->Arg(2)->Arg(4)->Arg(8)->UseRealTime();
+
 // Sharded padded counters to avoid false sharing
 struct alignas(CLS) PaddedCounter {
   std::uint64_t v{0};
@@ -59,12 +117,14 @@ static void BM_ShardedCounters(benchmark::State& st) {
   const std::size_t total_increments = 64ull * 1024ull * 1024ull; // 64M
   const std::size_t iters_per_thread = total_increments / static_cast<std::size_t>(threads);
 
-  for (auto _ : st) {
+  for (auto _ : perfc::counted(st)) {
     std::vector<PaddedCounter> shards(static_cast<std::size_t>(threads));
     std::vector<std::thread> ts;
     ts.reserve(static_cast<std::size_t>(threads));
     for (int t = 0; t < threads; ++t) {
       ts.emplace_back([t, &shards, iters_per_thread]() {
+        TRACE_THREAD_NAME("writer");
+        TRACE_SCOPE("shard_loop");
         // Each thread updates its own cache-line-private shard
         for (std::size_t i = 0; i < iters_per_thread; ++i) {
           // No need for atomics when each thread exclusively owns its shard
@@ -84,4 +144,160 @@ static void BM_ShardedCounters(benchmark::State& st) {
 }
 BENCHMARK(BM_ShardedCounters)->Arg(2)->Arg(4)->Arg(8);
 
+// ---------------------------------------------------------------------------
+// Statistical counter readable while writers run. Each writer owns a padded
+// shard and accumulates increments there with plain (relaxed, RMW-free)
+// stores; every K increments, or on flush(), the shard's pending count is
+// folded into the global value with one fetch_add. Readers load the global
+// value: it lags the true count by at most shards * (K - 1), and it is exact
+// once every writer has flushed. read_precise() also sums the shards' pending
+// counts, trading an O(shards) read for a lag bounded by in-flight flushes.
+// ---------------------------------------------------------------------------
+class StatCounter {
+public:
+  StatCounter(std::size_t shards, std::uint64_t flush_every)
+      : shards_(shards), flush_every_(flush_every ? flush_every : 1) {}
+
+  // Writer side: only the thread that owns `shard` may call these.
+  void add(std::size_t shard, std::uint64_t n = 1) {
+    auto& pending = shards_[shard].pending;
+    const std::uint64_t p = pending.load(std::memory_order_relaxed) + n;
+    if (p >= flush_every_) {
+      TRACE_INSTANT("flush");
+      pending.store(0, std::memory_order_relaxed);
+      global_.fetch_add(p, std::memory_order_relaxed);
+    } else {
+      pending.store(p, std::memory_order_relaxed);
+    }
+  }
+
+  void flush(std::size_t shard) {
+    auto& pending = shards_[shard].pending;
+    const std::uint64_t p = pending.load(std::memory_order_relaxed);
+    if (p == 0) return;
+    pending.store(0, std::memory_order_relaxed);
+    global_.fetch_add(p, std::memory_order_relaxed);
+  }
+
+  // Reader side: any thread, any time.
+  std::uint64_t read() const { return global_.load(std::memory_order_relaxed); }
+
+  std::uint64_t read_precise() const {
+    std::uint64_t sum = global_.load(std::memory_order_relaxed);
+    for (const auto& s : shards_) sum += s.pending.load(std::memory_order_relaxed);
+    return sum;
+  }
+
+  // Worst-case amount by which read() trails the increments already made.
+  std::uint64_t staleness_bound() const { return shards_.size() * (flush_every_ - 1); }
+
+private:
+  struct alignas(CLS) Shard {
+    std::atomic<std::uint64_t> pending{0};
+  };
+
+  std::vector<Shard> shards_;
+  std::uint64_t flush_every_;
+  alignas(CLS) std::atomic<std::uint64_t> global_{0};
+};
+
+// Poll `read` at a fixed rate until `done`; returns the number of reads.
+// Periods of 100us and up sleep, shorter ones spin on the clock.
+template <class ReadFn>
+NOINLINE std::uint64_t poll_reader(const std::atomic<bool>& done, std::int64_t hz, ReadFn&& read) {
+  using clock = std::chrono::steady_clock;
+  const auto period = std::chrono::nanoseconds(1'000'000'000 / hz);
+  auto next = clock::now();
+  std::uint64_t reads = 0, sink = 0;
+  TRACE_THREAD_NAME("reader");
+  while (!done.load(std::memory_order_acquire)) {
+    TRACE_INSTANT("read");
+    sink += read();
+    ++reads;
+    next += period;
+    if (period >= std::chrono::microseconds(100)) {
+      std::this_thread::sleep_until(next);
+    } else {
+      while (clock::now() < next) {}
+    }
+  }
+  benchmark::DoNotOptimize(sink);
+  return reads;
+}
+
+// Writers + one reader thread polling at Arg(2) Hz; Arg(0) = writer threads.
+static void BM_SharedAtomicCounter_Polled(benchmark::State& st) {
+  const int threads = static_cast<int>(st.range(0));
+  const std::int64_t hz = st.range(1);
+  const std::size_t total_increments = 64ull * 1024ull * 1024ull;
+  const std::size_t iters_per_thread = total_increments / static_cast<std::size_t>(threads);
+
+  std::uint64_t reads = 0;
+  for (auto _ : perfc::counted(st)) {
+    std::atomic<std::uint64_t> shared{0};
+    std::atomic<bool> done{false};
+    std::thread reader([&] { reads += poll_reader(done, hz, [&] { return shared.load(std::memory_order_relaxed); }); });
+    std::vector<std::thread> ts;
+    ts.reserve(static_cast<std::size_t>(threads));
+    for (int t = 0; t < threads; ++t) {
+      ts.emplace_back([&shared, iters_per_thread]() {
+        TRACE_THREAD_NAME("writer");
+        TRACE_SCOPE("fetch_add_loop");
+        for (std::size_t i = 0; i < iters_per_thread; ++i) shared.fetch_add(1, std::memory_order_relaxed);
+      });
+    }
+    for (auto& th : ts) th.join();
+    done.store(true, std::memory_order_release);
+    reader.join();
+    benchmark::DoNotOptimize(shared.load(std::memory_order_relaxed));
+  }
+  st.counters["reads"] = benchmark::Counter(static_cast<double>(reads), benchmark::Counter::kAvgIterations);
+  st.SetLabel("shared_atomic_polled");
+}
+BENCHMARK(BM_SharedAtomicCounter_Polled)
+    ->ArgsProduct({{2, 4, 8}, {1'000, 1'000'000}})
+    ->ArgNames({"threads", "hz"})
+    ->UseRealTime();
+
+// Arg(writer threads, flush every K, reader poll Hz)
+static void BM_StatCounter_Polled(benchmark::State& st) {
+  const int threads = static_cast<int>(st.range(0));
+  const auto flush_every = static_cast<std::uint64_t>(st.range(1));
+  const std::int64_t hz = st.range(2);
+  const std::size_t total_increments = 64ull * 1024ull * 1024ull;
+  const std::size_t iters_per_thread = total_increments / static_cast<std::size_t>(threads);
+
+  std::uint64_t reads = 0;
+  for (auto _ : perfc::counted(st)) {
+    StatCounter counter(static_cast<std::size_t>(threads), flush_every);
+    std::atomic<bool> done{false};
+    std::thread reader([&] { reads += poll_reader(done, hz, [&] { return counter.read(); }); });
+    std::vector<std::thread> ts;
+    ts.reserve(static_cast<std::size_t>(threads));
+    for (int t = 0; t < threads; ++t) {
+      ts.emplace_back([&counter, t, iters_per_thread]() {
+        TRACE_THREAD_NAME("writer");
+        TRACE_SCOPE("stat_add_loop");
+        const auto shard = static_cast<std::size_t>(t);
+        for (std::size_t i = 0; i < iters_per_thread; ++i) counter.add(shard);
+        counter.flush(shard);
+      });
+    }
+    for (auto& th : ts) th.join();
+    done.store(true, std::memory_order_release);
+    reader.join();
+    if (counter.read() != iters_per_thread * static_cast<std::size_t>(threads)) {
+      st.SkipWithError("flushed count mismatch");
+      break;
+    }
+    st.counters["staleness_bound"] = static_cast<double>(counter.staleness_bound());
+  }
+  st.counters["reads"] = benchmark::Counter(static_cast<double>(reads), benchmark::Counter::kAvgIterations);
+  st.SetLabel("stat_counter_batched_flush");
+}
+BENCHMARK(BM_StatCounter_Polled)
+    ->ArgsProduct({{2, 4, 8}, {64, 1024}, {1'000, 1'000'000}})
+    ->ArgNames({"threads", "k", "hz"})
+    ->UseRealTime();
+
 BENCHMARK_MAIN();
\ No newline at end of file
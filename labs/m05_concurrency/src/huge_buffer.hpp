@@ -0,0 +1,100 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <utility>
+
+#include <sys/mman.h>
+
+// Page backing requested for a large buffer.
+enum class PagePolicy {
+  Default,         // plain anonymous mapping, 4K pages
+  TransparentHuge, // 2M-aligned mapping + madvise(MADV_HUGEPAGE); THP may or may not back it
+  ExplicitHuge,    // MAP_HUGETLB from the reserved pool; falls back to TransparentHuge
+};
+
+// Page-aligned, zero-filled anonymous mapping, optionally backed by huge pages.
+// Large rings sized from config at startup live here instead of on the stack
+// or in BSS, and huge pages cut the dTLB misses of sweeping a multi-MB ring.
+class HugeBuffer {
+public:
+  static constexpr std::size_t kHugePage = std::size_t{2} << 20;
+
+  HugeBuffer() = default;
+
+  // Throws std::bad_alloc when no mapping can be obtained at all.
+  explicit HugeBuffer(std::size_t bytes, PagePolicy policy = PagePolicy::Default) {
+    if (policy == PagePolicy::ExplicitHuge) {
+#if defined(MAP_HUGETLB)
+      const std::size_t len = round_up(bytes, kHugePage);
+      void *p = mmap(nullptr, len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+      if (p != MAP_FAILED) {
+        base_ = p;
+        len_ = len;
+        backing_ = PagePolicy::ExplicitHuge;
+        return;
+      }
+#endif
+      policy = PagePolicy::TransparentHuge; // hugetlbfs pool empty or unsupported
+    }
+    if (policy == PagePolicy::TransparentHuge) {
+      // Over-map by one huge page and trim so the region starts 2M-aligned;
+      // THP can only back fully aligned 2M extents.
+      const std::size_t len = round_up(bytes, kHugePage);
+      void *raw = mmap(nullptr, len + kHugePage, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+      if (raw == MAP_FAILED) throw std::bad_alloc();
+      auto *lo = static_cast<std::byte *>(raw);
+      auto *aligned = reinterpret_cast<std::byte *>(round_up(reinterpret_cast<std::uintptr_t>(lo), kHugePage));
+      if (aligned > lo) munmap(lo, static_cast<std::size_t>(aligned - lo));
+      std::byte *end = aligned + len;
+      std::byte *raw_end = lo + len + kHugePage;
+      if (raw_end > end) munmap(end, static_cast<std::size_t>(raw_end - end));
+#if defined(MADV_HUGEPAGE)
+      madvise(aligned, len, MADV_HUGEPAGE);
+#endif
+      base_ = aligned;
+      len_ = len;
+      backing_ = PagePolicy::TransparentHuge;
+      return;
+    }
+    const std::size_t len = bytes ? bytes : 1;
+    void *p = mmap(nullptr, len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (p == MAP_FAILED) throw std::bad_alloc();
+    base_ = p;
+    len_ = len;
+    backing_ = PagePolicy::Default;
+  }
+
+  HugeBuffer(HugeBuffer &&o) noexcept
+      : base_(std::exchange(o.base_, nullptr)), len_(std::exchange(o.len_, 0)), backing_(o.backing_) {}
+  HugeBuffer &operator=(HugeBuffer &&o) noexcept {
+    if (this != &o) {
+      release();
+      base_ = std::exchange(o.base_, nullptr);
+      len_ = std::exchange(o.len_, 0);
+      backing_ = o.backing_;
+    }
+    return *this;
+  }
+  HugeBuffer(const HugeBuffer &) = delete;
+  HugeBuffer &operator=(const HugeBuffer &) = delete;
+  ~HugeBuffer() { release(); }
+
+  void *data() const { return base_; }
+  std::size_t size() const { return len_; }
+  // What the kernel actually gave us (ExplicitHuge requests may degrade).
+  PagePolicy backing() const { return backing_; }
+
+private:
+  static constexpr std::size_t round_up(std::size_t v, std::size_t a) { return (v + a - 1) / a * a; }
+
+  void release() {
+    if (base_) munmap(base_, len_);
+    base_ = nullptr;
+    len_ = 0;
+  }
+
+  void *base_ = nullptr;
+  std::size_t len_ = 0;
+  PagePolicy backing_ = PagePolicy::Default;
+};
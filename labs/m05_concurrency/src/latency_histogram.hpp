@@ -0,0 +1,103 @@
+#pragma once
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Log-linear latency histogram in the spirit of HdrHistogram.
+// Values below 2^SubBucketBits are recorded exactly; above that, every power-of-two
+// range is split into 2^SubBucketBits linear sub-buckets, so the relative quantization
+// error is bounded by 2^-SubBucketBits (about 3% for the default of 5 bits) at every
+// magnitude. Recording is a count-leading-zeros, a shift and an increment: cheap
+// enough to sit on the measured path.
+template <unsigned SubBucketBits = 5>
+class LatencyHistogram {
+  static_assert(SubBucketBits >= 1 && SubBucketBits < 32, "SubBucketBits out of range");
+
+public:
+  static constexpr std::size_t sub_buckets = std::size_t{1} << SubBucketBits;
+  static constexpr std::size_t bucket_count = (65 - SubBucketBits) * sub_buckets;
+
+  LatencyHistogram() : counts_(bucket_count, 0) {}
+
+  void record(std::uint64_t v) {
+    ++counts_[index_of(v)];
+    ++total_;
+    max_ = std::max(max_, v);
+  }
+
+  void merge(const LatencyHistogram &o) {
+    for (std::size_t i = 0; i < bucket_count; ++i) counts_[i] += o.counts_[i];
+    total_ += o.total_;
+    max_ = std::max(max_, o.max_);
+  }
+
+  void reset() {
+    std::fill(counts_.begin(), counts_.end(), 0);
+    total_ = 0;
+    max_ = 0;
+  }
+
+  // Raw bucket access for shipping a histogram across a process boundary
+  // (e.g. copying it into shared memory from a forked child).
+  const std::uint64_t *buckets() const { return counts_.data(); }
+
+  void merge_buckets(const std::uint64_t *counts, std::uint64_t max_value) {
+    for (std::size_t i = 0; i < bucket_count; ++i) {
+      counts_[i] += counts[i];
+      total_ += counts[i];
+    }
+    max_ = std::max(max_, max_value);
+  }
+
+  std::uint64_t count() const { return total_; }
+  std::uint64_t max() const { return max_; }
+
+  // Upper bound of the bucket holding the p-th percentile (p in [0, 100]).
+  // Reporting the bucket's upper edge keeps the estimate conservative.
+  std::uint64_t percentile(double p) const {
+    if (total_ == 0) return 0;
+    const double clamped = std::clamp(p, 0.0, 100.0);
+    auto rank = static_cast<std::uint64_t>(clamped / 100.0 * static_cast<double>(total_) + 0.5);
+    rank = std::clamp<std::uint64_t>(rank, 1, total_);
+    std::uint64_t seen = 0;
+    for (std::size_t i = 0; i < bucket_count; ++i) {
+      seen += counts_[i];
+      if (seen >= rank) return std::min(upper_bound_of(i), max_);
+    }
+    return max_;
+  }
+
+private:
+  static std::size_t index_of(std::uint64_t v) {
+    if (v < sub_buckets) return static_cast<std::size_t>(v);
+    const unsigned msb = 63u - static_cast<unsigned>(std::countl_zero(v)); // >= SubBucketBits
+    const unsigned shift = msb - SubBucketBits;
+    const std::size_t sub = static_cast<std::size_t>(v >> shift) - sub_buckets;
+    return (shift + 1) * sub_buckets + sub;
+  }
+
+  static std::uint64_t upper_bound_of(std::size_t idx) {
+    const std::size_t mag = idx / sub_buckets;
+    const std::size_t sub = idx % sub_buckets;
+    if (mag == 0) return sub;
+    const std::size_t shift = mag - 1;
+    return ((static_cast<std::uint64_t>(sub_buckets + sub) + 1) << shift) - 1;
+  }
+
+  std::vector<std::uint64_t> counts_;
+  std::uint64_t total_ = 0;
+  std::uint64_t max_ = 0;
+};
+
+// Publish the standard tail-latency percentiles (in nanoseconds) as benchmark counters.
+template <unsigned B>
+void report_latency(benchmark::State &st, const LatencyHistogram<B> &h) {
+  st.counters["p50_ns"] = benchmark::Counter(static_cast<double>(h.percentile(50.0)));
+  st.counters["p90_ns"] = benchmark::Counter(static_cast<double>(h.percentile(90.0)));
+  st.counters["p99_ns"] = benchmark::Counter(static_cast<double>(h.percentile(99.0)));
+  st.counters["p999_ns"] = benchmark::Counter(static_cast<double>(h.percentile(99.9)));
+  st.counters["max_ns"] = benchmark::Counter(static_cast<double>(h.max()));
+}
@@ -0,0 +1,102 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+#include "cache_line.hpp"
+#include "reclamation.hpp"
+
+// Unbounded multi-producer/multi-consumer queue after Michael & Scott,
+// "Simple, Fast, and Practical Non-Blocking and Blocking Concurrent Queue
+// Algorithms" (PODC'96). head_ points at a dummy node whose successor holds
+// the front value; a pop swings head_ forward and retires the old dummy
+// through the Reclaimer (HazardPointers<2> or EpochReclaimer), which is what
+// makes freeing it safe while other poppers may still be reading it.
+//
+//   MsQueue<int, EpochReclaimer> q;
+//   auto h = q.attach();   // per thread
+//   q.push(h, 1);
+//   int v; q.try_pop(h, v);
+//
+// Never full: push allocates a node, so bursts cost memory instead of
+// blocking the producer. Memory held = queued nodes + domain().pending().
+template <class T, class Reclaimer = HazardPointers<2>>
+class MsQueue {
+  static_assert(std::is_trivially_copyable_v<T>, "T is copied out before the CAS that claims it");
+
+  struct Node {
+    std::atomic<Node *> next{nullptr};
+    T value{};
+  };
+
+public:
+  using Handle = typename Reclaimer::Handle;
+
+  MsQueue() {
+    Node *dummy = new Node;
+    head_.store(dummy, std::memory_order_relaxed);
+    tail_.store(dummy, std::memory_order_relaxed);
+  }
+  MsQueue(const MsQueue &) = delete;
+  MsQueue &operator=(const MsQueue &) = delete;
+  // Single-threaded by now: free the remaining chain directly.
+  ~MsQueue() {
+    for (Node *n = head_.load(std::memory_order_relaxed); n;) delete std::exchange(n, n->next.load(std::memory_order_relaxed));
+  }
+
+  Handle attach() { return domain_.attach(); }
+
+  void push(Handle &h, const T &v) {
+    Node *n = new Node;
+    n->value = v;
+    auto g = h.guard();
+    for (;;) {
+      Node *tail = g.protect(0, tail_);
+      Node *next = tail->next.load(std::memory_order_acquire);
+      if (tail != tail_.load(std::memory_order_acquire)) continue;
+      if (next) { // tail lags: help the slow pusher, then retry
+        tail_.compare_exchange_weak(tail, next, std::memory_order_release, std::memory_order_relaxed);
+        continue;
+      }
+      if (tail->next.compare_exchange_weak(next, n, std::memory_order_release, std::memory_order_relaxed)) {
+        tail_.compare_exchange_strong(tail, n, std::memory_order_release, std::memory_order_relaxed);
+        return;
+      }
+    }
+  }
+
+  bool try_pop(Handle &h, T &out) {
+    Node *head;
+    {
+      auto g = h.guard();
+      for (;;) {
+        head = g.protect(0, head_);
+        Node *tail = tail_.load(std::memory_order_acquire);
+        Node *next = g.protect(1, head->next);
+        // next was read through a live head: recheck head is still current so next is too.
+        if (head != head_.load(std::memory_order_acquire)) continue;
+        if (!next) return false;
+        if (head == tail) { // push linked next but has not swung tail_ yet
+          tail_.compare_exchange_weak(tail, next, std::memory_order_release, std::memory_order_relaxed);
+          continue;
+        }
+        const T v = next->value;
+        if (head_.compare_exchange_weak(head, next, std::memory_order_acq_rel, std::memory_order_relaxed)) {
+          out = v;
+          break;
+        }
+      }
+    }
+    h.retire(head);
+    return true;
+  }
+
+  const Reclaimer &domain() const { return domain_; }
+  static constexpr std::size_t node_bytes() { return sizeof(Node); }
+
+private:
+  alignas(kCacheLine) std::atomic<Node *> head_;
+  alignas(kCacheLine) std::atomic<Node *> tail_;
+  alignas(kCacheLine) Reclaimer domain_;
+};
@@ -0,0 +1,213 @@
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "backoff.hpp"
+#include "ms_queue.hpp"
+#include "perf_counters.hpp"
+#include "reclamation.hpp"
+#include "spsc_ring.hpp"
+
+#if defined(__clang__) || defined(__GNUC__)
+  #define NOINLINE [[gnu::noinline]]
+#elif defined(_MSC_VER)
+  #define NOINLINE __declspec(noinline)
+#else
+  #define NOINLINE
+#endif
+
+// ---------------------------------------------------------------------------
+// Pairs: every thread alternates push/pop on one shared queue, the classic
+// Michael-Scott workload. Each thread samples the domain's retired-but-unfreed
+// count as it goes; the peak is the reclamation scheme's memory overhead.
+// ---------------------------------------------------------------------------
+
+constexpr std::size_t kPairsPerThread = 1u << 16;
+constexpr std::size_t kSampleEvery = 256;
+
+struct alignas(kCacheLine) PairsResult {
+  std::uint64_t sum = 0;
+  std::size_t failed_pops = 0;
+  std::size_t peak_pending = 0;
+};
+
+template <class Q>
+NOINLINE void pairs_worker(Q *q, std::size_t tid, std::atomic<bool> *start, PairsResult *out) {
+  auto h = q->attach();
+  while (!start->load(std::memory_order_acquire)) {}
+  PairsResult r;
+  for (std::size_t i = 0; i < kPairsPerThread; ++i) {
+    q->push(h, (tid << 32) | i);
+    std::uint64_t v;
+    while (!q->try_pop(h, v)) ++r.failed_pops; // cannot be empty: our own push precedes it
+    r.sum += v;
+    if (i % kSampleEvery == 0) r.peak_pending = std::max(r.peak_pending, q->domain().pending());
+  }
+  *out = r;
+}
+
+template <class Reclaimer>
+static void BM_MsQueue_Pairs(benchmark::State &st) {
+  using Q = MsQueue<std::uint64_t, Reclaimer>;
+  const auto threads = static_cast<std::size_t>(st.range(0));
+  std::size_t peak_pending = 0, failed = 0;
+  for (auto _ : perfc::counted(st)) {
+    perfc::pause_timing(st);
+    auto q = std::make_unique<Q>();
+    std::atomic<bool> start{false};
+    std::vector<PairsResult> results(threads);
+    std::vector<std::thread> ts;
+    ts.reserve(threads);
+    for (std::size_t t = 0; t < threads; ++t) ts.emplace_back(pairs_worker<Q>, q.get(), t, &start, &results[t]);
+    start.store(true, std::memory_order_release);
+    perfc::resume_timing(st);
+    for (auto &t : ts) t.join();
+    perfc::pause_timing(st);
+    std::uint64_t sum = 0, expect = 0;
+    for (std::size_t t = 0; t < threads; ++t) {
+      sum += results[t].sum;
+      failed += results[t].failed_pops;
+      peak_pending = std::max(peak_pending, results[t].peak_pending);
+      for (std::size_t i = 0; i < kPairsPerThread; ++i) expect += (t << 32) | i;
+    }
+    if (sum != expect) st.SkipWithError("popped values do not match pushed values");
+    q.reset(); // frees the leftover garbage outside the timed region
+    perfc::resume_timing(st);
+  }
+  st.SetItemsProcessed(static_cast<int64_t>(st.iterations() * threads * kPairsPerThread));
+  st.counters["peak_pending"] = static_cast<double>(peak_pending);
+  st.counters["peak_garbage_KiB"] = static_cast<double>(peak_pending * Q::node_bytes()) / 1024.0;
+  st.counters["failed_pops"] = static_cast<double>(failed);
+  st.SetLabel(Reclaimer::name);
+}
+
+#define PAIRS_ARGS Arg(1)->Arg(2)->Arg(4)->Arg(8)->Arg(16)->ArgName("threads")->UseRealTime()
+
+BENCHMARK_TEMPLATE(BM_MsQueue_Pairs, HazardPointers<2>)->PAIRS_ARGS;
+BENCHMARK_TEMPLATE(BM_MsQueue_Pairs, EpochReclaimer)->PAIRS_ARGS;
+
+// ---------------------------------------------------------------------------
+// Bursts: one producer emits bursts faster than the consumer drains them.
+// The bounded ring must stall the producer once it fills; the unbounded queue
+// absorbs the burst and pays in memory (queued nodes + unreclaimed garbage).
+// ---------------------------------------------------------------------------
+
+constexpr std::size_t kBurst = 1u << 13;
+constexpr std::size_t kBursts = 64;
+constexpr unsigned kConsumerWork = 64; // dependent multiply-adds per item
+
+template <class Reclaimer>
+struct MsQueueAdapter {
+  MsQueue<std::uint64_t, Reclaimer> q;
+  using Handle = typename MsQueue<std::uint64_t, Reclaimer>::Handle;
+  static constexpr const char *name = Reclaimer::name;
+  Handle attach() { return q.attach(); }
+  bool try_push(Handle &h, std::uint64_t v) {
+    q.push(h, v);
+    return true;
+  }
+  bool try_pop(Handle &h, std::uint64_t &v) { return q.try_pop(h, v); }
+  std::size_t held_bytes(std::size_t depth) const {
+    return (depth + 1 + q.domain().pending()) * decltype(q)::node_bytes();
+  }
+};
+
+struct BoundedRingAdapter {
+  SpscRing<std::uint64_t, 1024> ring;
+  struct Handle {};
+  static constexpr const char *name = "bounded_spsc_ring_1024";
+  Handle attach() { return {}; }
+  bool try_push(Handle &, std::uint64_t v) { return ring.try_push(v); }
+  bool try_pop(Handle &, std::uint64_t &v) { return ring.try_pop(v); }
+  std::size_t held_bytes(std::size_t) const { return sizeof(ring); }
+};
+
+struct BurstResult {
+  std::size_t stalls = 0;
+  std::size_t peak_depth = 0;
+  std::size_t peak_held = 0;
+};
+
+template <class Q>
+NOINLINE void burst_producer(Q *q, std::atomic<bool> *start, const std::atomic<std::size_t> *popped,
+                             BurstResult *out) {
+  auto h = q->attach();
+  while (!start->load(std::memory_order_acquire)) {}
+  BurstResult r;
+  std::uint64_t next = 0;
+  for (std::size_t b = 0; b < kBursts; ++b) {
+    SpinThenYield wait;
+    for (std::size_t i = 0; i < kBurst; ++i) {
+      while (!q->try_push(h, next)) {
+        ++r.stalls;
+        wait();
+      }
+      ++next;
+    }
+    const std::size_t depth = next - popped->load(std::memory_order_relaxed);
+    r.peak_depth = std::max(r.peak_depth, depth);
+    r.peak_held = std::max(r.peak_held, q->held_bytes(depth));
+  }
+  *out = r;
+}
+
+template <class Q>
+NOINLINE void burst_consumer(Q *q, std::atomic<bool> *start, std::atomic<std::size_t> *popped, std::uint64_t *sum) {
+  auto h = q->attach();
+  while (!start->load(std::memory_order_acquire)) {}
+  std::uint64_t s = 0, v;
+  SpinThenYield wait;
+  for (std::size_t n = 0; n < kBursts * kBurst;) {
+    if (!q->try_pop(h, v)) {
+      wait();
+      continue;
+    }
+    wait.reset();
+    for (unsigned k = 0; k < kConsumerWork; ++k) v = v * 6364136223846793005ull + 1442695040888963407ull;
+    s += v;
+    popped->store(++n, std::memory_order_relaxed);
+  }
+  *sum = s;
+}
+
+template <class Q>
+static void BM_Queue_Burst(benchmark::State &st) {
+  BurstResult agg;
+  for (auto _ : perfc::counted(st)) {
+    perfc::pause_timing(st);
+    auto q = std::make_unique<Q>();
+    std::atomic<bool> start{false};
+    std::atomic<std::size_t> popped{0};
+    BurstResult r;
+    std::uint64_t sum = 0;
+    std::thread tp(burst_producer<Q>, q.get(), &start, &popped, &r);
+    std::thread tc(burst_consumer<Q>, q.get(), &start, &popped, &sum);
+    start.store(true, std::memory_order_release);
+    perfc::resume_timing(st);
+    tp.join();
+    tc.join();
+    perfc::pause_timing(st);
+    benchmark::DoNotOptimize(sum);
+    agg.stalls += r.stalls;
+    agg.peak_depth = std::max(agg.peak_depth, r.peak_depth);
+    agg.peak_held = std::max(agg.peak_held, r.peak_held);
+    q.reset();
+    perfc::resume_timing(st);
+  }
+  st.SetItemsProcessed(static_cast<int64_t>(st.iterations() * kBursts * kBurst));
+  st.counters["producer_stalls"] = benchmark::Counter(static_cast<double>(agg.stalls), benchmark::Counter::kAvgIterations);
+  st.counters["peak_depth"] = static_cast<double>(agg.peak_depth);
+  st.counters["peak_held_KiB"] = static_cast<double>(agg.peak_held) / 1024.0;
+  st.SetLabel(Q::name);
+}
+
+BENCHMARK_TEMPLATE(BM_Queue_Burst, BoundedRingAdapter)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_Queue_Burst, MsQueueAdapter<HazardPointers<2>>)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_Queue_Burst, MsQueueAdapter<EpochReclaimer>)->UseRealTime();
+
+BENCHMARK_MAIN();
@@ -0,0 +1,243 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "affinity.hpp"
+#include "backoff.hpp"
+#include "cache_line.hpp"
+#include "spsc_ring.hpp"
+
+// ---------------------------------------------------------------------------
+// Linear multi-stage pipeline over SpscRing links. Every stage is a callable
+// running on its own thread; neighbours talk through one SPSC ring, so each
+// link keeps the single-producer/single-consumer contract.
+//
+//   auto p = Pipeline<>::source("decode", gen)       // std::optional<T>()
+//                .stage("transform", f, {.cpu = 3})  // U(const T&)
+//                .sink("aggregate", g);              // void(const U&)
+//   p.run();
+//
+// Items move in batches: a stage pops up to `batch` items with one acquire,
+// transforms them, and publishes the results with one release. A full
+// downstream ring blocks the stage (backpressure) instead of dropping items.
+// Per-stage counters show which stage is the bottleneck: its input ring sits
+// near full, its output ring near empty, and its busy fraction is highest.
+// ---------------------------------------------------------------------------
+
+struct StageOptions {
+  int cpu = -1;            // pin the stage thread to this CPU (< 0: leave unpinned)
+  std::size_t batch = 64;  // max items per pop/push handoff
+};
+
+// Written only by the owning stage thread; read after run() joins.
+struct alignas(kCacheLine) StageStats {
+  std::string name;
+  std::uint64_t items = 0;          // items emitted downstream (consumed, for the sink)
+  std::uint64_t batches = 0;        // non-empty handoffs from the input ring
+  std::uint64_t starved = 0;        // polls that found the input ring empty
+  std::uint64_t blocked = 0;        // pushes that found the output ring full
+  std::uint64_t occupancy_sum = 0;  // input ring fill level summed per handoff
+  std::uint64_t busy_ns = 0;        // time inside the user callable
+
+  // Mean fill fraction of the input ring, sampled once per handoff.
+  double occupancy(std::size_t capacity) const {
+    return batches ? static_cast<double>(occupancy_sum) / (static_cast<double>(batches) * static_cast<double>(capacity))
+                   : 0.0;
+  }
+};
+
+template <std::size_t Capacity = 4096>
+class Pipeline {
+public:
+  template <class T>
+  class Builder;
+
+  // Start a pipeline from a generator returning std::optional<T>; std::nullopt ends the stream.
+  template <class Gen>
+  static auto source(std::string name, Gen gen, StageOptions opt = {}) {
+    using T = typename std::invoke_result_t<Gen &>::value_type;
+    Builder<T> b(std::unique_ptr<Pipeline>(new Pipeline));
+    StageStats *st = b.p_->add_stats(std::move(name));
+    b.finish_ = [p = b.p_.get(), gen = std::move(gen), opt, st](Link<T> *out) mutable {
+      p->bodies_.push_back([gen = std::move(gen), opt, st, out]() mutable { run_source(gen, *out, opt, *st); });
+    };
+    return b;
+  }
+
+  // Launch one thread per stage and block until the sink has drained the stream.
+  void run() {
+    std::vector<std::thread> ts;
+    ts.reserve(bodies_.size());
+    const auto t0 = std::chrono::steady_clock::now();
+    for (auto &body : bodies_) ts.emplace_back(body);
+    for (auto &t : ts) t.join();
+    elapsed_s_ = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+  }
+
+  std::size_t stages() const { return stats_.size(); }
+  const StageStats &stats(std::size_t i) const { return *stats_[i]; }
+  double elapsed_seconds() const { return elapsed_s_; }
+  static constexpr std::size_t capacity() { return Capacity - 1; } // one slot stays empty
+
+private:
+  template <class T>
+  struct Link {
+    SpscRing<T, Capacity> ring;
+    alignas(kCacheLine) std::atomic<bool> closed{false}; // producer finished
+  };
+
+  Pipeline() = default;
+
+  StageStats *add_stats(std::string name) {
+    stats_.push_back(std::make_unique<StageStats>());
+    stats_.back()->name = std::move(name);
+    return stats_.back().get();
+  }
+
+  static std::uint64_t now_ns() {
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+  }
+
+  // Push the whole batch, waiting (backpressure) while the ring is full.
+  template <class T>
+  static void push_all(Link<T> &out, const T *xs, std::size_t n, StageStats &st) {
+    std::size_t off = 0;
+    SpinThenYield wait;
+    while (off < n) {
+      const std::size_t k = out.ring.push_many(xs + off, n - off);
+      if (k == 0) {
+        ++st.blocked;
+        wait();
+      }
+      off += k;
+    }
+    st.items += n;
+  }
+
+  // Pop up to `max` items; returns 0 only once upstream closed and the ring is drained.
+  template <class T>
+  static std::size_t pop_batch(Link<T> &in, T *xs, std::size_t max, StageStats &st) {
+    SpinThenYield wait;
+    for (;;) {
+      const std::size_t level = in.ring.size_approx();
+      if (std::size_t k = in.ring.pop_many(xs, max)) {
+        ++st.batches;
+        st.occupancy_sum += level;
+        return k;
+      }
+      // closed is released after the producer's last push, so one more pop sees it all.
+      if (in.closed.load(std::memory_order_acquire)) return in.ring.pop_many(xs, max);
+      ++st.starved;
+      wait();
+    }
+  }
+
+  template <class T, class Gen>
+  static void run_source(Gen &gen, Link<T> &out, const StageOptions &opt, StageStats &st) {
+    if (opt.cpu >= 0) pin_this_thread(static_cast<unsigned>(opt.cpu));
+    std::vector<T> batch;
+    batch.reserve(opt.batch);
+    for (bool more = true; more;) {
+      batch.clear();
+      const std::uint64_t t0 = now_ns();
+      while (batch.size() < opt.batch) {
+        std::optional<T> v = gen();
+        if (!v) {
+          more = false;
+          break;
+        }
+        batch.push_back(*v);
+      }
+      st.busy_ns += now_ns() - t0;
+      push_all(out, batch.data(), batch.size(), st);
+    }
+    out.closed.store(true, std::memory_order_release);
+  }
+
+  template <class T, class U, class F>
+  static void run_stage(F &f, Link<T> &in, Link<U> &out, const StageOptions &opt, StageStats &st) {
+    if (opt.cpu >= 0) pin_this_thread(static_cast<unsigned>(opt.cpu));
+    std::vector<T> src(opt.batch);
+    std::vector<U> dst(opt.batch);
+    while (std::size_t k = pop_batch(in, src.data(), opt.batch, st)) {
+      const std::uint64_t t0 = now_ns();
+      for (std::size_t i = 0; i < k; ++i) dst[i] = f(src[i]);
+      st.busy_ns += now_ns() - t0;
+      push_all(out, dst.data(), k, st);
+    }
+    out.closed.store(true, std::memory_order_release);
+  }
+
+  template <class T, class F>
+  static void run_sink(F &f, Link<T> &in, const StageOptions &opt, StageStats &st) {
+    if (opt.cpu >= 0) pin_this_thread(static_cast<unsigned>(opt.cpu));
+    std::vector<T> src(opt.batch);
+    while (std::size_t k = pop_batch(in, src.data(), opt.batch, st)) {
+      const std::uint64_t t0 = now_ns();
+      for (std::size_t i = 0; i < k; ++i) f(src[i]);
+      st.busy_ns += now_ns() - t0;
+      st.items += k;
+    }
+  }
+
+  std::vector<std::function<void()>> bodies_;
+  std::vector<std::shared_ptr<void>> links_;
+  std::vector<std::unique_ptr<StageStats>> stats_;
+  double elapsed_s_ = 0.0;
+};
+
+// Builder for a pipeline whose last stage so far emits T. The last stage's
+// thread body is only materialised once the next stage creates its output link.
+template <std::size_t Capacity>
+template <class T>
+class Pipeline<Capacity>::Builder {
+public:
+  template <class F>
+  auto stage(std::string name, F f, StageOptions opt = {}) && {
+    using U = std::decay_t<std::invoke_result_t<F &, const T &>>;
+    Link<T> *in = connect();
+    Builder<U> next(std::move(p_));
+    StageStats *st = next.p_->add_stats(std::move(name));
+    next.finish_ = [p = next.p_.get(), f = std::move(f), opt, st, in](Link<U> *out) mutable {
+      p->bodies_.push_back([f = std::move(f), opt, st, in, out]() mutable { run_stage(f, *in, *out, opt, *st); });
+    };
+    return next;
+  }
+
+  template <class F>
+  Pipeline sink(std::string name, F f, StageOptions opt = {}) && {
+    Link<T> *in = connect();
+    StageStats *st = p_->add_stats(std::move(name));
+    p_->bodies_.push_back([f = std::move(f), opt, st, in]() mutable { run_sink(f, *in, opt, *st); });
+    return std::move(*p_);
+  }
+
+private:
+  friend class Pipeline;
+  template <class>
+  friend class Builder;
+  explicit Builder(std::unique_ptr<Pipeline> p) : p_(std::move(p)) {}
+
+  Link<T> *connect() {
+    auto link = std::make_shared<Link<T>>();
+    Link<T> *raw = link.get();
+    p_->links_.push_back(std::move(link));
+    finish_(raw);
+    return raw;
+  }
+
+  std::unique_ptr<Pipeline> p_;
+  std::function<void(Link<T> *)> finish_;
+};
@@ -0,0 +1,88 @@
+#include <benchmark/benchmark.h>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+
+#include "perf_counters.hpp"
+#include "pipeline.hpp"
+
+// Stand-in for per-item work: n rounds of a cheap integer mix the optimizer
+// cannot fold away.
+static inline std::uint64_t burn(std::uint64_t x, std::int64_t n) {
+  for (std::int64_t i = 0; i < n; ++i) {
+    x ^= x >> 29;
+    x *= 0xbf58476d1ce4e5b9ull;
+  }
+  return x;
+}
+
+struct Raw {
+  std::uint64_t seq;
+  std::uint64_t bits;
+};
+
+struct Decoded {
+  std::uint64_t key;
+  std::uint64_t value;
+};
+
+using Pipe = Pipeline<4096>;
+
+// decode -> transform -> enrich -> aggregate, each stage pinned to its own core.
+static Pipe build_pipeline(std::uint64_t items, const std::int64_t (&cost)[4], std::size_t batch,
+                           std::uint64_t *checksum) {
+  auto opt = [batch](int cpu) { return StageOptions{.cpu = cpu, .batch = batch}; };
+  const std::int64_t c0 = cost[0], c1 = cost[1], c2 = cost[2], c3 = cost[3];
+  return Pipe::source("decode",
+                      [seq = std::uint64_t{0}, items, c0]() mutable -> std::optional<Raw> {
+                        if (seq == items) return std::nullopt;
+                        const std::uint64_t s = seq++;
+                        return Raw{s, burn(s, c0)};
+                      },
+                      opt(2))
+      .stage("transform", [c1](const Raw &r) { return Decoded{r.seq, burn(r.bits, c1)}; }, opt(3))
+      .stage("enrich", [c2](const Decoded &d) { return Decoded{d.key, burn(d.value, c2)}; }, opt(4))
+      .sink("aggregate", [c3, checksum](const Decoded &d) { *checksum += burn(d.value, c3) & 1; }, opt(5));
+}
+
+// Arg(cost_decode, cost_transform, cost_enrich, cost_aggregate, batch)
+// Costs are burn() rounds per item; raise one stage's cost to watch it become
+// the bottleneck (high busy fraction, input ring near full, upstream blocked).
+static void BM_Pipeline_4Stage(benchmark::State &st) {
+  const std::int64_t cost[4] = {st.range(0), st.range(1), st.range(2), st.range(3)};
+  const std::size_t batch = static_cast<std::size_t>(st.range(4));
+  constexpr std::uint64_t items = 1u << 18;
+
+  std::uint64_t checksum = 0;
+  std::optional<Pipe> p;
+  for (auto _ : perfc::counted(st)) {
+    perfc::pause_timing(st);
+    checksum = 0;
+    p.emplace(build_pipeline(items, cost, batch, &checksum));
+    perfc::resume_timing(st);
+    p->run();
+    benchmark::DoNotOptimize(checksum);
+  }
+  if (p->stats(p->stages() - 1).items != items) st.SkipWithError("sink lost items");
+  st.SetItemsProcessed(static_cast<int64_t>(st.iterations() * items));
+  // Counters describe the last run: per-stage busy fraction, mean input-ring
+  // fill and how often the stage found its output ring full.
+  for (std::size_t i = 0; i < p->stages(); ++i) {
+    const StageStats &s = p->stats(i);
+    std::string k = "s";
+    k += std::to_string(i);
+    k += '_';
+    st.counters[k + "busy"] = static_cast<double>(s.busy_ns) / (p->elapsed_seconds() * 1e9);
+    if (i > 0) st.counters[k + "in_occ"] = s.occupancy(Pipe::capacity());
+    if (i + 1 < p->stages()) st.counters[k + "blocked"] = static_cast<double>(s.blocked);
+  }
+  st.SetLabel("decode>transform>enrich>aggregate");
+}
+BENCHMARK(BM_Pipeline_4Stage)
+    ->Args({20, 20, 20, 20, 64})   // balanced
+    ->Args({20, 20, 200, 20, 64})  // enrich is the bottleneck
+    ->Args({20, 20, 20, 20, 1})    // balanced, no batching: handoff cost dominates
+    ->UseRealTime();
+
+BENCHMARK_MAIN();
@@ -0,0 +1,179 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "backoff.hpp"
+#include "cache_line.hpp"
+#include "reclamation.hpp"
+
+// ---------------------------------------------------------------------------
+// Read-copy-update for rarely written, constantly read objects (configs,
+// routing tables). Readers dereference the current version with one acquire
+// load: no RMW, no fence, no shared write. Writers build a new version off to
+// the side, swap the pointer, and hand the old one to the domain, which frees
+// it after a grace period.
+//
+// Grace periods use quiescent-state-based reclamation (QSBR): each reader
+// thread reports a quiescent state at points where it holds no RCU pointer,
+// typically between requests. A version retired at grace-period tag g is
+// freed once every online reader has reported a quiescent state after g.
+// EpochReclaimer (reclamation.hpp) is the alternative when reader threads
+// cannot promise regular quiescent points: it pays a fence per read instead.
+//
+//   RcuDomain rcu;
+//   RcuPtr<Config> cfg(rcu, std::make_unique<Config>());
+//   auto r = rcu.attach();          // per reader thread
+//   for (;;) {
+//     const Config *c = cfg.read(); // valid until r.quiescent()
+//     serve(*c);
+//     r.quiescent();
+//   }
+//   cfg.update(std::make_unique<Config>(...)); // any thread
+// ---------------------------------------------------------------------------
+
+class RcuDomain {
+  struct alignas(kCacheLine) Record {
+    std::atomic<std::uint64_t> seen{0}; // last grace-period tag observed; 0 = offline
+    std::atomic<bool> in_use{false};
+    Record *next = nullptr;
+  };
+
+public:
+  // Per reader thread. Starts online; a thread about to block for long
+  // (I/O, condition variable) should go offline so it does not hold up
+  // reclamation, and must not keep RCU pointers across that.
+  class Reader {
+  public:
+    Reader(Reader &&o) noexcept : d_(o.d_), rec_(std::exchange(o.rec_, nullptr)) {}
+    Reader(const Reader &) = delete;
+    Reader &operator=(const Reader &) = delete;
+    ~Reader() {
+      if (rec_) {
+        offline();
+        reclaim_detail::RecordList<Record>::release(rec_);
+      }
+    }
+
+    // Declares every pointer read so far dead. The release orders those reads
+    // before the announcement a writer waits for. One load and one store,
+    // both to lines that stay in this core's cache between grace periods.
+    void quiescent() { rec_->seen.store(d_->gp_.load(std::memory_order_acquire), std::memory_order_release); }
+    void offline() { rec_->seen.store(0, std::memory_order_release); }
+    // Going from offline to online is a store (seen) followed by loads of RCU
+    // pointers; the fence keeps a writer scanning after its gp_ bump from
+    // still seeing 0 here and freeing what this thread is about to read
+    // (smp_mb in liburcu's rcu_thread_online). Pairs with the fence in
+    // retire()/synchronize().
+    void online() {
+      quiescent();
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+    }
+
+  private:
+    friend class RcuDomain;
+    Reader(RcuDomain *d, Record *r) : d_(d), rec_(r) { online(); }
+    RcuDomain *d_;
+    Record *rec_;
+  };
+
+  RcuDomain() = default;
+  RcuDomain(const RcuDomain &) = delete;
+  RcuDomain &operator=(const RcuDomain &) = delete;
+  ~RcuDomain() {
+    for (auto &x : limbo_) x.second.del(x.second.p);
+  }
+
+  Reader attach() { return Reader(this, records_.acquire()); }
+
+  // Defer freeing p until the current readers have all passed a quiescent
+  // state. Never blocks; frees whatever earlier retirements have matured.
+  template <class T>
+  void retire(T *p) {
+    // Bumping the tag after the caller unpublished p: a reader that reports
+    // this tag (or later) read gp_ after the unpublish, so it cannot still hold p.
+    const std::uint64_t tag = gp_.fetch_add(1, std::memory_order_acq_rel) + 1;
+    std::atomic_thread_fence(std::memory_order_seq_cst); // pairs with Reader::online()
+    std::lock_guard lk(mu_);
+    limbo_.push_back({tag, {p, &reclaim_detail::delete_as<T>}});
+    reclaim_locked();
+  }
+
+  // Block until everything retired so far has been freed (shutdown, tests).
+  void synchronize() {
+    const std::uint64_t tag = gp_.fetch_add(1, std::memory_order_acq_rel) + 1;
+    std::atomic_thread_fence(std::memory_order_seq_cst); // pairs with Reader::online()
+    SpinThenPark wait;
+    while (min_seen() < tag) wait();
+    std::lock_guard lk(mu_);
+    reclaim_locked();
+  }
+
+  std::size_t pending() const {
+    std::lock_guard lk(mu_);
+    return limbo_.size();
+  }
+
+private:
+  // Oldest tag any online reader might still be running under.
+  std::uint64_t min_seen() const {
+    std::uint64_t m = gp_.load(std::memory_order_acquire);
+    for (Record *r = records_.head(); r; r = r->next) {
+      const std::uint64_t s = r->seen.load(std::memory_order_acquire);
+      if (s != 0) m = std::min(m, s);
+    }
+    return m;
+  }
+
+  void reclaim_locked() {
+    const std::uint64_t safe = min_seen();
+    auto keep = std::partition(limbo_.begin(), limbo_.end(), [safe](const auto &x) { return x.first > safe; });
+    for (auto it = keep; it != limbo_.end(); ++it) it->second.del(it->second.p);
+    limbo_.erase(keep, limbo_.end());
+  }
+
+  alignas(kCacheLine) std::atomic<std::uint64_t> gp_{1}; // grace-period tag; 0 is reserved for offline
+  reclaim_detail::RecordList<Record> records_;
+  mutable std::mutex mu_; // writers only
+  std::vector<std::pair<std::uint64_t, reclaim_detail::Retired>> limbo_;
+};
+
+// Pointer to an RCU-managed object. The object is immutable once published:
+// update() replaces it wholesale, it is never modified in place.
+template <class T>
+class RcuPtr {
+public:
+  RcuPtr(RcuDomain &d, std::unique_ptr<T> init) : d_(&d), p_(init.release()) {}
+  RcuPtr(const RcuPtr &) = delete;
+  RcuPtr &operator=(const RcuPtr &) = delete;
+  ~RcuPtr() { d_->retire(p_.load(std::memory_order_relaxed)); }
+
+  // Reader side: valid until this thread's next quiescent() / offline().
+  const T *read() const { return p_.load(std::memory_order_acquire); }
+
+  // Writer side: publish next, retire the previous version.
+  void update(std::unique_ptr<T> next) {
+    T *old = p_.exchange(next.release(), std::memory_order_acq_rel);
+    d_->retire(old);
+  }
+
+  // Copy the current version, let f edit the copy, publish it. Concurrent
+  // copy-updates of one pointer serialize so none of the edits is lost.
+  template <class F>
+  void copy_update(F &&f) {
+    std::lock_guard lk(update_mu_);
+    auto next = std::make_unique<T>(*p_.load(std::memory_order_acquire));
+    f(*next);
+    update(std::move(next));
+  }
+
+private:
+  RcuDomain *d_;
+  alignas(kCacheLine) std::atomic<T *> p_;
+  std::mutex update_mu_;
+};
@@ -0,0 +1,199 @@
+#include <benchmark/benchmark.h>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+#include <vector>
+
+#include "backoff.hpp"
+#include "cache_line.hpp"
+#include "perf_counters.hpp"
+#include "rcu.hpp"
+
+#if defined(__clang__) || defined(__GNUC__)
+  #define NOINLINE [[gnu::noinline]]
+#elif defined(_MSC_VER)
+  #define NOINLINE __declspec(noinline)
+#else
+  #define NOINLINE
+#endif
+
+// A config object read on every request. Every field carries the version it
+// was built for, so a reader can tell a consistent object from a freed or
+// half-built one.
+struct Config {
+  std::uint64_t version = 0;
+  std::uint64_t knobs[15] = {};
+
+  static std::unique_ptr<Config> make(std::uint64_t v) {
+    auto c = std::make_unique<Config>();
+    c->version = v;
+    for (auto &k : c->knobs) k = v;
+    return c;
+  }
+  bool consistent() const {
+    for (auto k : knobs) {
+      if (k != version) return false;
+    }
+    return true;
+  }
+};
+
+// ---------------------------------------------------------------------------
+// Read-mostly publication with a common interface:
+//   auto r = box.attach();        // per reader thread
+//   box.read(r, f);               // one request: f(const Config&)
+//   box.update(std::unique_ptr<Config>);
+// ---------------------------------------------------------------------------
+
+// RCU: one acquire load per read, plus a quiescent report per request.
+class RcuBox {
+public:
+  static constexpr const char *name = "rcu_qsbr";
+  using Reader = RcuDomain::Reader;
+  RcuBox() : cfg_(rcu_, Config::make(0)) {}
+  Reader attach() { return rcu_.attach(); }
+  template <class F>
+  void read(Reader &r, F &&f) const {
+    f(*cfg_.read());
+    r.quiescent();
+  }
+  void update(std::unique_ptr<Config> c) { cfg_.update(std::move(c)); }
+
+private:
+  RcuDomain rcu_;
+  RcuPtr<Config> cfg_;
+};
+
+// Reader-writer lock: every read is two RMWs on the shared lock word.
+class SharedMutexConfigBox {
+public:
+  static constexpr const char *name = "shared_mutex";
+  struct Reader {};
+  SharedMutexConfigBox() : cfg_(Config::make(0)) {}
+  Reader attach() { return {}; }
+  template <class F>
+  void read(Reader &, F &&f) const {
+    std::shared_lock lk(mu_);
+    f(*cfg_);
+  }
+  void update(std::unique_ptr<Config> c) {
+    std::unique_lock lk(mu_);
+    cfg_ = std::move(c);
+  }
+
+private:
+  mutable std::shared_mutex mu_;
+  std::unique_ptr<Config> cfg_;
+};
+
+// std::atomic<std::shared_ptr>: each read copies the shared_ptr, i.e. an
+// increment and a decrement on the control block's shared count (and, in
+// libstdc++, a lock bit in the atomic itself).
+class AtomicSharedPtrBox {
+public:
+  static constexpr const char *name = "atomic_shared_ptr";
+  struct Reader {};
+  AtomicSharedPtrBox() : cfg_(std::shared_ptr<const Config>(Config::make(0))) {}
+  Reader attach() { return {}; }
+  template <class F>
+  void read(Reader &, F &&f) const {
+    std::shared_ptr<const Config> c = cfg_.load(std::memory_order_acquire);
+    f(*c);
+  }
+  void update(std::unique_ptr<Config> c) { cfg_.store(std::shared_ptr<const Config>(std::move(c)), std::memory_order_release); }
+
+private:
+  std::atomic<std::shared_ptr<const Config>> cfg_;
+};
+
+// ---------------------------------------------------------------------------
+// Harness: Arg(0) readers serve kRequestsPerReader requests each while one
+// writer publishes a new version Arg(1) times per second.
+// ---------------------------------------------------------------------------
+
+constexpr std::size_t kRequestsPerReader = 1u << 18;
+
+struct alignas(kCacheLine) ReaderResult {
+  std::uint64_t torn = 0;
+  std::uint64_t sink = 0;
+};
+
+template <class Box>
+NOINLINE void reader_body(Box *box, const std::atomic<bool> *start, ReaderResult *out) {
+  auto r = box->attach();
+  SpinThenYield wait;
+  while (!start->load(std::memory_order_acquire)) wait();
+  ReaderResult res;
+  for (std::size_t i = 0; i < kRequestsPerReader; ++i) {
+    box->read(r, [&](const Config &c) {
+      if (!c.consistent()) ++res.torn;
+      res.sink += c.knobs[i & 7] + c.version;
+    });
+  }
+  *out = res;
+}
+
+template <class Box>
+NOINLINE std::uint64_t writer_body(Box *box, const std::atomic<bool> *start, const std::atomic<bool> *done,
+                                   std::int64_t rate) {
+  using clock = std::chrono::steady_clock;
+  SpinThenYield wait;
+  while (!start->load(std::memory_order_acquire)) wait();
+  const auto period = std::chrono::nanoseconds(1'000'000'000 / rate);
+  auto next = clock::now();
+  std::uint64_t v = 0;
+  while (!done->load(std::memory_order_acquire)) {
+    box->update(Config::make(++v));
+    next += period;
+    std::this_thread::sleep_until(next);
+  }
+  return v;
+}
+
+template <class Box>
+static void BM_ConfigRead(benchmark::State &st) {
+  const auto readers = static_cast<std::size_t>(st.range(0));
+  const std::int64_t rate = st.range(1);
+  std::uint64_t torn = 0, writes = 0;
+  for (auto _ : perfc::counted(st)) {
+    perfc::pause_timing(st);
+    auto box = std::make_unique<Box>();
+    std::atomic<bool> start{false}, done{false};
+    std::vector<ReaderResult> results(readers);
+    std::vector<std::thread> ts;
+    ts.reserve(readers);
+    for (std::size_t r = 0; r < readers; ++r) ts.emplace_back(reader_body<Box>, box.get(), &start, &results[r]);
+    std::uint64_t w = 0;
+    std::thread writer([&] { w = writer_body<Box>(box.get(), &start, &done, rate); });
+    start.store(true, std::memory_order_release);
+    perfc::resume_timing(st);
+    for (auto &t : ts) t.join();
+    perfc::pause_timing(st);
+    done.store(true, std::memory_order_release);
+    writer.join();
+    writes += w;
+    for (const auto &r : results) {
+      torn += r.torn;
+      benchmark::DoNotOptimize(r.sink);
+    }
+    box.reset();
+    perfc::resume_timing(st);
+  }
+  if (torn) st.SkipWithError("reader saw an inconsistent config");
+  st.SetItemsProcessed(static_cast<int64_t>(st.iterations() * readers * kRequestsPerReader));
+  st.counters["writes"] = benchmark::Counter(static_cast<double>(writes), benchmark::Counter::kAvgIterations);
+  st.SetLabel(Box::name);
+}
+
+#define CONFIG_ARGS ArgsProduct({{1, 4, 16, 64}, {10, 1'000}})->ArgNames({"readers", "writes_per_s"})->UseRealTime()
+
+BENCHMARK_TEMPLATE(BM_ConfigRead, RcuBox)->CONFIG_ARGS;
+BENCHMARK_TEMPLATE(BM_ConfigRead, SharedMutexConfigBox)->CONFIG_ARGS;
+BENCHMARK_TEMPLATE(BM_ConfigRead, AtomicSharedPtrBox)->CONFIG_ARGS;
+
+BENCHMARK_MAIN();
@@ -0,0 +1,313 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "cache_line.hpp"
+
+// ---------------------------------------------------------------------------
+// Safe memory reclamation for lock-free structures that unlink nodes while
+// other threads may still be reading them. Two interchangeable domains:
+//
+//   HazardPointers  - each reader publishes the few pointers it is about to
+//                     dereference; a retired node is freed once no slot holds
+//                     it. Bounded garbage, a fence per protected load.
+//   EpochReclaimer  - readers announce the global epoch while inside an
+//                     operation; garbage is freed two epochs later. Loads are
+//                     plain acquires, but one stalled reader blocks every free.
+//
+// Both are used the same way:
+//
+//   auto h = domain.attach();             // once per thread (move-only handle)
+//   { auto g = h.guard();                 // one operation
+//     Node *n = g.protect(0, head);       // safe to dereference until g dies
+//     ...
+//     h.retire(unlinked); }               // deleted once no reader can see it
+//
+// A thread record is claimed by attach() and returned when the handle dies;
+// its leftover garbage stays with the record for the next owner or for the
+// domain destructor, which frees everything (no handle may outlive the domain).
+// ---------------------------------------------------------------------------
+
+namespace reclaim_detail {
+struct Retired {
+  void *p;
+  void (*del)(void *);
+};
+
+template <class T>
+void delete_as(void *p) { delete static_cast<T *>(p); }
+
+// Intrusive list of thread records: pushed with CAS, never unlinked before
+// the domain dies, reused through the in_use flag.
+template <class Rec>
+class RecordList {
+public:
+  RecordList() = default;
+  RecordList(const RecordList &) = delete;
+  RecordList &operator=(const RecordList &) = delete;
+  ~RecordList() {
+    for (Rec *r = head_.load(std::memory_order_relaxed); r;) delete std::exchange(r, r->next);
+  }
+
+  Rec *acquire() {
+    for (Rec *r = head(); r; r = r->next) {
+      bool expected = false;
+      if (!r->in_use.load(std::memory_order_relaxed) &&
+          r->in_use.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+        return r;
+      }
+    }
+    Rec *r = new Rec;
+    r->in_use.store(true, std::memory_order_relaxed);
+    Rec *h = head_.load(std::memory_order_relaxed);
+    do {
+      r->next = h;
+    } while (!head_.compare_exchange_weak(h, r, std::memory_order_release, std::memory_order_relaxed));
+    count_.fetch_add(1, std::memory_order_relaxed);
+    return r;
+  }
+
+  static void release(Rec *r) { r->in_use.store(false, std::memory_order_release); }
+
+  Rec *head() const { return head_.load(std::memory_order_acquire); }
+  std::size_t size() const { return count_.load(std::memory_order_relaxed); }
+
+private:
+  std::atomic<Rec *> head_{nullptr};
+  std::atomic<std::size_t> count_{0};
+};
+} // namespace reclaim_detail
+
+// Michael, "Hazard Pointers: Safe Memory Reclamation for Lock-Free Objects"
+// (TPDS'04), with K slots per thread.
+template <unsigned K = 2>
+class HazardPointers {
+  struct alignas(kCacheLine) Record {
+    std::atomic<void *> hp[K]{};
+    std::atomic<bool> in_use{false};
+    Record *next = nullptr;
+    // Owner-only (read by pending() for reporting).
+    std::vector<reclaim_detail::Retired> retired;
+    std::atomic<std::size_t> pending{0};
+  };
+
+public:
+  static constexpr const char *name = "hazard_pointers";
+
+  class Guard {
+  public:
+    // Load src and publish it in `slot` until it is stable: once the re-read
+    // matches, any retire() of that node must see the slot (fence pairing
+    // with scan()). The store is a release so a scanner that reads it also
+    // sees this thread done with whatever the slot protected before.
+    template <class T>
+    T *protect(unsigned slot, const std::atomic<T *> &src) {
+      T *p = src.load(std::memory_order_relaxed);
+      for (;;) {
+        rec_->hp[slot].store(p, std::memory_order_release);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        T *again = src.load(std::memory_order_acquire);
+        if (again == p) return p;
+        p = again;
+      }
+    }
+
+    Guard(const Guard &) = delete;
+    Guard &operator=(const Guard &) = delete;
+    ~Guard() {
+      for (auto &h : rec_->hp) h.store(nullptr, std::memory_order_release);
+    }
+
+  private:
+    friend class HazardPointers;
+    explicit Guard(Record *r) : rec_(r) {}
+    Record *rec_;
+  };
+
+  class Handle {
+  public:
+    Handle(Handle &&o) noexcept : d_(o.d_), rec_(std::exchange(o.rec_, nullptr)) {}
+    Handle(const Handle &) = delete;
+    Handle &operator=(const Handle &) = delete;
+    ~Handle() {
+      if (rec_) reclaim_detail::RecordList<Record>::release(rec_);
+    }
+
+    Guard guard() { return Guard(rec_); }
+
+    template <class T>
+    void retire(T *p) {
+      rec_->retired.push_back({p, &reclaim_detail::delete_as<T>});
+      rec_->pending.store(rec_->retired.size(), std::memory_order_relaxed);
+      if (rec_->retired.size() >= d_->threshold()) d_->scan(*rec_);
+    }
+
+  private:
+    friend class HazardPointers;
+    Handle(HazardPointers *d, Record *r) : d_(d), rec_(r) {}
+    HazardPointers *d_;
+    Record *rec_;
+  };
+
+  HazardPointers() = default;
+  HazardPointers(const HazardPointers &) = delete;
+  HazardPointers &operator=(const HazardPointers &) = delete;
+  ~HazardPointers() {
+    for (Record *r = records_.head(); r; r = r->next) {
+      for (auto &x : r->retired) x.del(x.p);
+    }
+  }
+
+  Handle attach() { return Handle(this, records_.acquire()); }
+
+  // Retired nodes not yet freed, over all records (approximate while running).
+  std::size_t pending() const {
+    std::size_t n = 0;
+    for (Record *r = records_.head(); r; r = r->next) n += r->pending.load(std::memory_order_relaxed);
+    return n;
+  }
+
+private:
+  // Scan once per O(H) retires so the cost per free stays constant; at most
+  // H hazards can survive a scan, so a thread never holds more than ~2H nodes.
+  std::size_t threshold() const { return std::max<std::size_t>(64, 2 * K * records_.size()); }
+
+  void scan(Record &me) {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    std::vector<void *> hazards;
+    hazards.reserve(K * records_.size());
+    for (Record *r = records_.head(); r; r = r->next) {
+      for (auto &h : r->hp) {
+        if (void *p = h.load(std::memory_order_acquire)) hazards.push_back(p);
+      }
+    }
+    std::sort(hazards.begin(), hazards.end());
+    auto keep = std::partition(me.retired.begin(), me.retired.end(), [&](const reclaim_detail::Retired &x) {
+      return std::binary_search(hazards.begin(), hazards.end(), x.p);
+    });
+    for (auto it = keep; it != me.retired.end(); ++it) it->del(it->p);
+    me.retired.erase(keep, me.retired.end());
+    me.pending.store(me.retired.size(), std::memory_order_relaxed);
+  }
+
+  reclaim_detail::RecordList<Record> records_;
+};
+
+// Fraser, "Practical Lock-Freedom" (2004), ch. 5: epoch-based reclamation.
+// A node retired at epoch e is unreachable for every thread that pins at
+// e+1 or later; once the global epoch reaches e+2, everyone pinned before the
+// unlink has left its operation and the node can go.
+class EpochReclaimer {
+  struct alignas(kCacheLine) Record {
+    std::atomic<std::uint64_t> state{0}; // (epoch << 1) | 1 while pinned, 0 when quiescent
+    std::atomic<bool> in_use{false};
+    Record *next = nullptr;
+    // Owner-only (read by pending() for reporting).
+    std::vector<std::pair<std::uint64_t, reclaim_detail::Retired>> limbo;
+    std::atomic<std::size_t> pending{0};
+    unsigned since_collect = 0;
+  };
+
+public:
+  static constexpr const char *name = "epoch";
+  static constexpr unsigned kCollectEvery = 64; // retires between advance attempts
+
+  class Guard {
+  public:
+    template <class T>
+    T *protect(unsigned, const std::atomic<T *> &src) {
+      return src.load(std::memory_order_acquire);
+    }
+
+    Guard(const Guard &) = delete;
+    Guard &operator=(const Guard &) = delete;
+    ~Guard() { rec_->state.store(0, std::memory_order_release); }
+
+  private:
+    friend class EpochReclaimer;
+    Guard(EpochReclaimer *d, Record *r) : rec_(r) {
+      const std::uint64_t e = d->epoch_.load(std::memory_order_relaxed);
+      rec_->state.store((e << 1) | 1, std::memory_order_relaxed);
+      // Announce before touching shared pointers; pairs with the fence in try_advance().
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+    }
+    Record *rec_;
+  };
+
+  class Handle {
+  public:
+    Handle(Handle &&o) noexcept : d_(o.d_), rec_(std::exchange(o.rec_, nullptr)) {}
+    Handle(const Handle &) = delete;
+    Handle &operator=(const Handle &) = delete;
+    ~Handle() {
+      if (rec_) reclaim_detail::RecordList<Record>::release(rec_);
+    }
+
+    // Pin the current epoch for the guard's lifetime. Guards do not nest.
+    Guard guard() { return Guard(d_, rec_); }
+
+    template <class T>
+    void retire(T *p) {
+      const std::uint64_t e = d_->epoch_.load(std::memory_order_acquire);
+      rec_->limbo.push_back({e, {p, &reclaim_detail::delete_as<T>}});
+      rec_->pending.store(rec_->limbo.size(), std::memory_order_relaxed);
+      if (++rec_->since_collect >= kCollectEvery) {
+        rec_->since_collect = 0;
+        d_->collect(*rec_);
+      }
+    }
+
+  private:
+    friend class EpochReclaimer;
+    Handle(EpochReclaimer *d, Record *r) : d_(d), rec_(r) {}
+    EpochReclaimer *d_;
+    Record *rec_;
+  };
+
+  EpochReclaimer() = default;
+  EpochReclaimer(const EpochReclaimer &) = delete;
+  EpochReclaimer &operator=(const EpochReclaimer &) = delete;
+  ~EpochReclaimer() {
+    for (Record *r = records_.head(); r; r = r->next) {
+      for (auto &[e, x] : r->limbo) x.del(x.p);
+    }
+  }
+
+  Handle attach() { return Handle(this, records_.acquire()); }
+
+  std::size_t pending() const {
+    std::size_t n = 0;
+    for (Record *r = records_.head(); r; r = r->next) n += r->pending.load(std::memory_order_relaxed);
+    return n;
+  }
+
+  std::uint64_t epoch() const { return epoch_.load(std::memory_order_relaxed); }
+
+private:
+  // Advance the global epoch if every pinned thread has observed the current one.
+  void try_advance() {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    std::uint64_t e = epoch_.load(std::memory_order_relaxed);
+    for (Record *r = records_.head(); r; r = r->next) {
+      const std::uint64_t s = r->state.load(std::memory_order_acquire);
+      if ((s & 1) && (s >> 1) != e) return; // a straggler still runs in an older epoch
+    }
+    epoch_.compare_exchange_strong(e, e + 1, std::memory_order_acq_rel, std::memory_order_relaxed);
+  }
+
+  void collect(Record &me) {
+    try_advance();
+    const std::uint64_t e = epoch_.load(std::memory_order_acquire);
+    auto keep = std::partition(me.limbo.begin(), me.limbo.end(), [e](const auto &x) { return x.first + 2 > e; });
+    for (auto it = keep; it != me.limbo.end(); ++it) it->second.del(it->second.p);
+    me.limbo.erase(keep, me.limbo.end());
+    me.pending.store(me.limbo.size(), std::memory_order_relaxed);
+  }
+
+  alignas(kCacheLine) std::atomic<std::uint64_t> epoch_{0};
+  reclaim_detail::RecordList<Record> records_;
+};
@@ -0,0 +1,89 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#include "cache_line.hpp"
+
+// ThreadSanitizer does not model std::atomic_thread_fence, so the fence-based
+// happens-before edges below are invisible to it. Mirror each fence with an
+// explicit acquire/release annotation on the sequence word when TSan is on.
+#if defined(__SANITIZE_THREAD__)
+  #define SEQLOCK_TSAN 1
+#elif defined(__has_feature)
+  #if __has_feature(thread_sanitizer)
+    #define SEQLOCK_TSAN 1
+  #endif
+#endif
+
+#if defined(SEQLOCK_TSAN)
+  #include <sanitizer/tsan_interface.h>
+  #define SEQLOCK_TSAN_RELEASE(addr) __tsan_release(const_cast<void *>(static_cast<const volatile void *>(addr)))
+  #define SEQLOCK_TSAN_ACQUIRE(addr) __tsan_acquire(const_cast<void *>(static_cast<const volatile void *>(addr)))
+#else
+  #define SEQLOCK_TSAN_RELEASE(addr) ((void)0)
+  #define SEQLOCK_TSAN_ACQUIRE(addr) ((void)0)
+#endif
+
+// Single-writer, multi-reader publication of a trivially copyable struct
+// larger than a word. Readers never write shared memory: they read the
+// sequence, copy the payload, and retry if the sequence was odd (write in
+// progress) or changed underneath them.
+//
+// The payload is stored as relaxed atomic words so a torn read is a detected
+// retry rather than a data race (UB). Ordering follows Boehm, "Can Seqlocks
+// Get Along With Programming Language Memory Models?" (MSPC'12):
+//   writer: seq = s+1; release fence; data stores; seq.store(s+2, release)
+//   reader: s0 = seq.load(acquire); data loads; acquire fence; s1 = seq.load()
+// If a reader saw any new word, the fence pair makes it also see seq != s0.
+template <class T>
+class Seqlock {
+  static_assert(std::is_trivially_copyable_v<T>, "T must be trivially copyable");
+  static constexpr std::size_t kWords = (sizeof(T) + sizeof(std::uint64_t) - 1) / sizeof(std::uint64_t);
+
+public:
+  Seqlock() = default;
+  explicit Seqlock(const T &init) { write(init); }
+  Seqlock(const Seqlock &) = delete;
+  Seqlock &operator=(const Seqlock &) = delete;
+
+  // Writer only (one thread at a time).
+  void write(const T &v) {
+    std::uint64_t w[kWords]{};
+    std::memcpy(w, &v, sizeof(T));
+    const std::uint64_t s = seq_.load(std::memory_order_relaxed);
+    seq_.store(s + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    SEQLOCK_TSAN_RELEASE(&seq_);
+    for (std::size_t i = 0; i < kWords; ++i) data_[i].store(w[i], std::memory_order_relaxed);
+    seq_.store(s + 2, std::memory_order_release);
+  }
+
+  // One attempt; false if it raced a write (out is left untouched).
+  bool try_read(T &out) const {
+    const std::uint64_t s0 = seq_.load(std::memory_order_acquire);
+    if (s0 & 1) return false;
+    std::uint64_t w[kWords];
+    for (std::size_t i = 0; i < kWords; ++i) w[i] = data_[i].load(std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    SEQLOCK_TSAN_ACQUIRE(&seq_);
+    if (seq_.load(std::memory_order_relaxed) != s0) return false;
+    std::memcpy(&out, w, sizeof(T));
+    return true;
+  }
+
+  T read() const {
+    T out;
+    while (!try_read(out)) {}
+    return out;
+  }
+
+  // Number of completed writes.
+  std::uint64_t version() const { return seq_.load(std::memory_order_acquire) / 2; }
+
+private:
+  alignas(kCacheLine) std::atomic<std::uint64_t> seq_{0};
+  std::atomic<std::uint64_t> data_[kWords]{}; // shares seq_'s line: one miss for small payloads
+};
@@ -0,0 +1,216 @@
+#include <benchmark/benchmark.h>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "backoff.hpp"
+#include "cache_line.hpp"
+#include "perf_counters.hpp"
+#include "seqlock.hpp"
+
+#if defined(__clang__) || defined(__GNUC__)
+  #define NOINLINE [[gnu::noinline]]
+#elif defined(_MSC_VER)
+  #define NOINLINE __declspec(noinline)
+#else
+  #define NOINLINE
+#endif
+
+// Published state: every word carries the same version, so a reader can tell
+// a torn snapshot from a consistent one.
+template <std::size_t Bytes>
+struct Blob {
+  static_assert(Bytes % sizeof(std::uint64_t) == 0, "Bytes must be a multiple of 8");
+  static constexpr std::size_t kWords = Bytes / sizeof(std::uint64_t);
+  std::uint64_t w[kWords];
+
+  void fill(std::uint64_t v) {
+    for (auto &x : w) x = v;
+  }
+  bool consistent() const {
+    for (auto x : w) {
+      if (x != w[0]) return false;
+    }
+    return true;
+  }
+};
+
+// ---------------------------------------------------------------------------
+// Publication primitives with a common interface: write(v) from one writer,
+// try_read(out) from any number of readers.
+// ---------------------------------------------------------------------------
+
+// Readers take a shared lock: every read is an RMW on the lock word.
+template <class T>
+class SharedMutexBox {
+public:
+  void write(const T &v) {
+    std::unique_lock lk(mu_);
+    value_ = v;
+  }
+  bool try_read(T &out) const {
+    std::shared_lock lk(mu_);
+    out = value_;
+    return true;
+  }
+
+private:
+  mutable std::shared_mutex mu_;
+  T value_{};
+};
+
+// Two buffers behind an atomic pointer. The writer fills the inactive buffer
+// and swaps the pointer; per-buffer reader counts keep it from overwriting a
+// buffer a slow reader is still copying. Readers never retry on a write, but
+// each read is two RMWs on a shared counter line.
+//
+// Reader (count++, recheck active_) and writer (store active_, later load the
+// count) are a Dekker pair: all four are seq_cst so that at least one side
+// sees the other. With acquire/release alone the writer's store can sit in
+// its store buffer while it reads count == 0 and the reader rereads the
+// stale pointer, and the writer then refills the buffer being copied.
+template <class T>
+class DoubleBuffer {
+public:
+  DoubleBuffer() : active_(&slots_[0]) {}
+
+  void write(const T &v) {
+    Slot *cur = active_.load(std::memory_order_relaxed);
+    Slot *next = cur == &slots_[0] ? &slots_[1] : &slots_[0];
+    SpinThenYield wait;
+    while (next->readers.load(std::memory_order_seq_cst) != 0) wait(); // drain stragglers
+    next->value = v;
+    active_.store(next, std::memory_order_seq_cst);
+  }
+
+  bool try_read(T &out) const {
+    for (;;) {
+      Slot *s = active_.load(std::memory_order_acquire);
+      s->readers.fetch_add(1, std::memory_order_seq_cst);
+      // Re-check: the writer may have flipped away and started refilling s.
+      if (active_.load(std::memory_order_seq_cst) == s) {
+        out = s->value;
+        s->readers.fetch_sub(1, std::memory_order_release);
+        return true;
+      }
+      s->readers.fetch_sub(1, std::memory_order_release);
+    }
+  }
+
+private:
+  struct alignas(kCacheLine) Slot {
+    mutable std::atomic<std::uint32_t> readers{0};
+    T value{};
+  };
+  Slot slots_[2];
+  alignas(kCacheLine) std::atomic<Slot *> active_;
+};
+
+// ---------------------------------------------------------------------------
+// Harness: one writer updating at Arg(1) writes/sec (0 = flat out) while
+// Arg(0) readers each take kReadsPerReader snapshots.
+// ---------------------------------------------------------------------------
+
+constexpr std::size_t kReadsPerReader = 1u << 18;
+
+struct ReaderResult {
+  std::uint64_t retries = 0;
+  std::uint64_t torn = 0;
+  std::uint64_t sink = 0;
+};
+
+template <class Box, class T>
+NOINLINE void reader_body(const Box *box, const std::atomic<bool> *start, ReaderResult *r) {
+  SpinThenYield wait;
+  while (!start->load(std::memory_order_acquire)) wait();
+  T snap;
+  for (std::size_t i = 0; i < kReadsPerReader; ++i) {
+    while (!box->try_read(snap)) ++r->retries;
+    if (!snap.consistent()) ++r->torn;
+    r->sink += snap.w[0];
+  }
+}
+
+template <class Box, class T>
+NOINLINE std::uint64_t writer_body(Box *box, const std::atomic<bool> *start, const std::atomic<bool> *done,
+                                   std::int64_t rate) {
+  using clock = std::chrono::steady_clock;
+  SpinThenYield wait;
+  while (!start->load(std::memory_order_acquire)) wait();
+  const auto period = rate > 0 ? std::chrono::nanoseconds(1'000'000'000 / rate) : std::chrono::nanoseconds(0);
+  auto next = clock::now();
+  std::uint64_t v = 0;
+  T blob;
+  while (!done->load(std::memory_order_acquire)) {
+    blob.fill(++v);
+    box->write(blob);
+    if (rate > 0) {
+      next += period;
+      if (period >= std::chrono::microseconds(100)) {
+        std::this_thread::sleep_until(next);
+      } else {
+        while (clock::now() < next && !done->load(std::memory_order_relaxed)) cpu_relax();
+      }
+    }
+  }
+  return v;
+}
+
+template <template <class> class BoxT, std::size_t Bytes>
+static void BM_Publish(benchmark::State &st) {
+  using T = Blob<Bytes>;
+  using Box = BoxT<T>;
+  const int readers = static_cast<int>(st.range(0));
+  const std::int64_t rate = st.range(1);
+  auto box = std::make_unique<Box>();
+
+  std::uint64_t retries = 0, torn = 0, writes = 0;
+  for (auto _ : perfc::counted(st)) {
+    perfc::pause_timing(st);
+    std::atomic<bool> start{false}, done{false};
+    std::vector<ReaderResult> results(static_cast<std::size_t>(readers));
+    std::vector<std::thread> ts;
+    for (int r = 0; r < readers; ++r) ts.emplace_back(reader_body<Box, T>, box.get(), &start, &results[static_cast<std::size_t>(r)]);
+    std::uint64_t w = 0;
+    std::thread writer([&] { w = writer_body<Box, T>(box.get(), &start, &done, rate); });
+    start.store(true, std::memory_order_release);
+    perfc::resume_timing(st);
+    for (auto &t : ts) t.join();
+    perfc::pause_timing(st);
+    done.store(true, std::memory_order_release);
+    writer.join();
+    perfc::resume_timing(st);
+    writes += w;
+    for (const auto &r : results) {
+      retries += r.retries;
+      torn += r.torn;
+      benchmark::DoNotOptimize(r.sink);
+    }
+  }
+  if (torn) st.SkipWithError("torn snapshot observed");
+  const double reads = static_cast<double>(st.iterations()) * static_cast<double>(readers * kReadsPerReader);
+  st.SetItemsProcessed(static_cast<int64_t>(reads));
+  st.counters["retries_per_read"] = static_cast<double>(retries) / reads;
+  st.counters["writes"] = benchmark::Counter(static_cast<double>(writes), benchmark::Counter::kAvgIterations);
+  st.SetLabel(std::to_string(Bytes) + "B");
+}
+
+#define PUBLISH_ARGS ArgsProduct({{1, 4, 16}, {0, 1'000, 1'000'000}})->ArgNames({"readers", "writes_per_s"})->UseRealTime()
+
+BENCHMARK_TEMPLATE(BM_Publish, Seqlock, 64)->PUBLISH_ARGS;
+BENCHMARK_TEMPLATE(BM_Publish, Seqlock, 128)->PUBLISH_ARGS;
+BENCHMARK_TEMPLATE(BM_Publish, Seqlock, 256)->PUBLISH_ARGS;
+BENCHMARK_TEMPLATE(BM_Publish, Seqlock, 512)->PUBLISH_ARGS;
+BENCHMARK_TEMPLATE(BM_Publish, SharedMutexBox, 64)->PUBLISH_ARGS;
+BENCHMARK_TEMPLATE(BM_Publish, SharedMutexBox, 512)->PUBLISH_ARGS;
+BENCHMARK_TEMPLATE(BM_Publish, DoubleBuffer, 64)->PUBLISH_ARGS;
+BENCHMARK_TEMPLATE(BM_Publish, DoubleBuffer, 512)->PUBLISH_ARGS;
+
+BENCHMARK_MAIN();
@@ -0,0 +1,394 @@
+#include <benchmark/benchmark.h>
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <new>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "affinity.hpp"
+#include "backoff.hpp"
+#include "latency_histogram.hpp"
+#include "perf_counters.hpp"
+
+#if defined(__clang__) || defined(__GNUC__)
+  #define NOINLINE [[gnu::noinline]]
+#elif defined(_MSC_VER)
+  #define NOINLINE __declspec(noinline)
+#else
+  #define NOINLINE
+#endif
+
+#if defined(__cpp_lib_hardware_interference_size)
+  constexpr std::size_t CLS = std::hardware_destructive_interference_size;
+#else
+  constexpr std::size_t CLS = 64;
+#endif
+
+// ---------------------------------------------------------------------------
+// Shared-memory region: memfd_create when available, otherwise a POSIX shm
+// object that is unlinked right after creation. Either way the mapping is
+// MAP_SHARED, so it survives fork() and can be attached by another process
+// through the fd.
+// ---------------------------------------------------------------------------
+class ShmRegion {
+public:
+  static std::optional<ShmRegion> create(const char *name, std::size_t bytes) {
+    int fd = -1;
+#if defined(__linux__) && defined(MFD_CLOEXEC)
+    fd = memfd_create(name, MFD_CLOEXEC);
+#endif
+    if (fd < 0) {
+      char path[64];
+      std::snprintf(path, sizeof(path), "/%s.%d", name, static_cast<int>(getpid()));
+      fd = shm_open(path, O_CREAT | O_EXCL | O_RDWR, 0600);
+      if (fd >= 0) shm_unlink(path);
+    }
+    if (fd < 0) return std::nullopt;
+    if (ftruncate(fd, static_cast<off_t>(bytes)) != 0) {
+      close(fd);
+      return std::nullopt;
+    }
+    void *p = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (p == MAP_FAILED) {
+      close(fd);
+      return std::nullopt;
+    }
+    return ShmRegion(fd, p, bytes);
+  }
+
+  ShmRegion(ShmRegion &&o) noexcept
+      : fd_(std::exchange(o.fd_, -1)), base_(std::exchange(o.base_, nullptr)), bytes_(std::exchange(o.bytes_, 0)) {}
+  ShmRegion &operator=(ShmRegion &&) = delete;
+  ShmRegion(const ShmRegion &) = delete;
+  ~ShmRegion() {
+    if (base_) munmap(base_, bytes_);
+    if (fd_ >= 0) close(fd_);
+  }
+
+  void *data() const { return base_; }
+  std::size_t size() const { return bytes_; }
+  int fd() const { return fd_; }
+
+private:
+  ShmRegion(int fd, void *base, std::size_t bytes) : fd_(fd), base_(base), bytes_(bytes) {}
+  int fd_;
+  void *base_;
+  std::size_t bytes_;
+};
+
+// ---------------------------------------------------------------------------
+// Inter-process SPSC ring. The region starts with a self-describing header
+// (magic, layout version, capacity, slot size) so an attaching process can
+// refuse a mismatched layout instead of reading garbage. Indices are free-
+// running 64-bit counters on separate cache lines; they are only ever accessed
+// through lock-free atomics, which are address-free and therefore valid across
+// processes. Slot contents are published with release/acquire exactly as in the
+// in-process SpscRing.
+// ---------------------------------------------------------------------------
+struct alignas(CLS) ShmRingHeader {
+  static constexpr std::uint32_t kMagic = 0x53505343; // "SPSC"
+  static constexpr std::uint32_t kVersion = 1;
+
+  std::atomic<std::uint32_t> magic;
+  std::uint32_t version;
+  std::uint64_t capacity;
+  std::uint64_t slot_size;
+
+  alignas(CLS) std::atomic<std::uint64_t> head; // written by producer
+  alignas(CLS) std::atomic<std::uint64_t> tail; // written by consumer
+};
+static_assert(std::atomic<std::uint64_t>::is_always_lock_free,
+              "shared-memory indices must be lock-free to be process-safe");
+
+template <class T>
+class ShmSpscRing {
+  static_assert(std::is_trivially_copyable_v<T>, "T must be trivially copyable");
+
+public:
+  static constexpr std::size_t slots_offset = (sizeof(ShmRingHeader) + CLS - 1) / CLS * CLS;
+
+  static std::size_t bytes_for(std::size_t capacity) { return slots_offset + capacity * sizeof(T); }
+
+  // Format a fresh region. Capacity must be a power of two.
+  static std::optional<ShmSpscRing> create(void *mem, std::size_t bytes, std::size_t capacity) {
+    if (capacity == 0 || (capacity & (capacity - 1)) != 0 || bytes < bytes_for(capacity)) return std::nullopt;
+    auto *h = new (mem) ShmRingHeader{};
+    h->capacity = capacity;
+    h->slot_size = sizeof(T);
+    h->version = ShmRingHeader::kVersion;
+    h->head.store(0, std::memory_order_relaxed);
+    h->tail.store(0, std::memory_order_relaxed);
+    // Magic last: an attacher that sees it also sees a fully formatted header.
+    h->magic.store(ShmRingHeader::kMagic, std::memory_order_release);
+    return ShmSpscRing(h);
+  }
+
+  // Attach to a region formatted by another process; rejects layout mismatches.
+  static std::optional<ShmSpscRing> attach(void *mem, std::size_t bytes) {
+    if (bytes < sizeof(ShmRingHeader)) return std::nullopt;
+    auto *h = static_cast<ShmRingHeader *>(mem);
+    if (h->magic.load(std::memory_order_acquire) != ShmRingHeader::kMagic ||
+        h->version != ShmRingHeader::kVersion || h->slot_size != sizeof(T) ||
+        bytes < bytes_for(static_cast<std::size_t>(h->capacity))) {
+      return std::nullopt;
+    }
+    return ShmSpscRing(h);
+  }
+
+  NOINLINE bool try_push(const T &x) {
+    const std::uint64_t h = hdr_->head.load(std::memory_order_relaxed);
+    if (h - tail_cache_ == mask_ + 1) {
+      tail_cache_ = hdr_->tail.load(std::memory_order_acquire); // observe consumer retirements
+      if (h - tail_cache_ == mask_ + 1) return false;            // full
+    }
+    std::memcpy(&slots_[h & mask_], &x, sizeof(T));
+    hdr_->head.store(h + 1, std::memory_order_release);
+    return true;
+  }
+
+  NOINLINE bool try_pop(T &out) {
+    const std::uint64_t t = hdr_->tail.load(std::memory_order_relaxed);
+    if (t == head_cache_) {
+      head_cache_ = hdr_->head.load(std::memory_order_acquire); // observe producer publishes
+      if (t == head_cache_) return false;                        // empty
+    }
+    std::memcpy(&out, &slots_[t & mask_], sizeof(T));
+    hdr_->tail.store(t + 1, std::memory_order_release);
+    return true;
+  }
+
+private:
+  explicit ShmSpscRing(ShmRingHeader *h)
+      : hdr_(h),
+        slots_(reinterpret_cast<T *>(reinterpret_cast<std::byte *>(h) + slots_offset)),
+        mask_(h->capacity - 1) {}
+
+  ShmRingHeader *hdr_;
+  T *slots_;
+  std::uint64_t mask_;
+  // Process-private copies of the other side's index: refreshed only when the
+  // ring looks full/empty, so the common case touches one shared line.
+  std::uint64_t tail_cache_ = 0;
+  std::uint64_t head_cache_ = 0;
+};
+
+// ---------------------------------------------------------------------------
+// Two-process harness
+// ---------------------------------------------------------------------------
+
+struct Msg {
+  std::uint64_t seq;
+  std::uint64_t sent_ns; // CLOCK_MONOTONIC is system-wide, so both processes agree
+};
+
+using Hist = LatencyHistogram<>;
+
+// Control block in its own anonymous shared mapping: start/ready handshake and
+// the consumer's results, copied back to the parent.
+struct ShmControl {
+  std::atomic<std::uint32_t> ready{0};
+  std::atomic<std::uint32_t> start{0};
+  std::uint64_t checksum = 0;
+  std::uint64_t max_ns = 0;
+  std::uint64_t buckets[Hist::bucket_count]{};
+};
+
+static inline std::uint64_t now_ns() {
+  return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+static ShmControl *map_control() {
+  void *p = mmap(nullptr, sizeof(ShmControl), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+  if (p == MAP_FAILED) return nullptr;
+  return new (p) ShmControl{};
+}
+
+// Child side: count messages, histogram one-way latency, ship results back.
+template <class RecvFn>
+[[noreturn]] static void run_consumer(ShmControl *ctl, std::size_t count, unsigned cpu, RecvFn &&recv) {
+  pin_this_thread(cpu);
+  Hist hist;
+  std::uint64_t sum = 0;
+  ctl->ready.store(1, std::memory_order_release);
+  SpinThenYield wait;
+  while (!ctl->start.load(std::memory_order_acquire)) wait();
+  Msg m{};
+  for (std::size_t i = 0; i < count; ++i) {
+    if (!recv(m)) _exit(1);
+    hist.record(now_ns() - m.sent_ns);
+    sum += m.seq;
+  }
+  ctl->checksum = sum;
+  ctl->max_ns = hist.max();
+  std::memcpy(ctl->buckets, hist.buckets(), sizeof(ctl->buckets));
+  _exit(0);
+}
+
+// True once the child has exited. WNOWAIT leaves it unreaped, so the final
+// waitpid() still collects its status.
+static bool child_exited(pid_t pid) {
+  siginfo_t si{};
+  return waitid(P_PID, static_cast<id_t>(pid), &si, WEXITED | WNOHANG | WNOWAIT) == 0 && si.si_pid == pid;
+}
+
+// Parent side: fork the consumer, wait for it to be ready, then time the send
+// loop until the child exits. send(msg, pid) returns false if the message
+// cannot be delivered (e.g. the consumer died). Returns false on any setup or
+// child failure, with timing resumed.
+template <class ChildFn, class SendFn>
+static bool run_two_process(benchmark::State &st, ShmControl *ctl, std::size_t count, Hist &hist,
+                            ChildFn &&child, SendFn &&send) {
+  perfc::pause_timing(st);
+  new (ctl) ShmControl{};
+  const pid_t pid = fork();
+  if (pid < 0) {
+    perfc::resume_timing(st);
+    return false;
+  }
+  if (pid == 0) child();
+  SpinThenYield wait;
+  while (!ctl->ready.load(std::memory_order_acquire)) {
+    if (child_exited(pid)) { // setup failed or crashed before the handshake
+      waitpid(pid, nullptr, 0);
+      perfc::resume_timing(st);
+      return false;
+    }
+    wait();
+  }
+  perfc::resume_timing(st);
+
+  ctl->start.store(1, std::memory_order_release);
+  for (std::size_t i = 0; i < count; ++i) {
+    if (!send(Msg{i, now_ns()}, pid)) {
+      kill(pid, SIGKILL); // the child would otherwise wait forever for the rest
+      break;
+    }
+  }
+  int status = 0;
+  waitpid(pid, &status, 0);
+
+  perfc::pause_timing(st);
+  const bool ok = WIFEXITED(status) && WEXITSTATUS(status) == 0 &&
+                  ctl->checksum == static_cast<std::uint64_t>(count) * (count - 1) / 2;
+  if (ok) hist.merge_buckets(ctl->buckets, ctl->max_ns);
+  perfc::resume_timing(st);
+  return ok;
+}
+
+static void BM_SPSC_Shm_TwoProcess(benchmark::State &st) {
+  const std::size_t items = static_cast<std::size_t>(st.range(0));
+  constexpr std::size_t capacity = 1u << 14; // 16K slots
+  using Ring = ShmSpscRing<Msg>;
+
+  auto region = ShmRegion::create("spsc_ring", Ring::bytes_for(capacity));
+  ShmControl *ctl = map_control();
+  if (!region || !ctl) {
+    st.SkipWithError("shared memory unavailable");
+    return;
+  }
+  Hist hist;
+  for (auto _ : perfc::counted(st)) {
+    perfc::pause_timing(st);
+    auto producer = Ring::create(region->data(), region->size(), capacity);
+    perfc::resume_timing(st);
+    auto child = [&] {
+      // Attach by layout, as an unrelated process mapping the same fd would.
+      auto consumer = Ring::attach(region->data(), region->size());
+      if (!consumer) _exit(2);
+      run_consumer(ctl, items, 3u, [&](Msg &m) {
+        SpinThenYield wait;
+        while (!consumer->try_pop(m)) wait();
+        return true;
+      });
+    };
+    // A full ring normally drains within microseconds; check every 4096
+    // failed pushes that the consumer is still there to drain it.
+    auto send = [&](const Msg &m, pid_t consumer_pid) {
+      SpinThenYield wait;
+      for (std::uint32_t tries = 1; !producer->try_push(m); ++tries) {
+        if (tries % 4096 == 0 && child_exited(consumer_pid)) return false;
+        wait();
+      }
+      return true;
+    };
+    if (!producer || !run_two_process(st, ctl, items, hist, child, send)) {
+      st.SkipWithError("consumer process failed");
+      break;
+    }
+  }
+  munmap(ctl, sizeof(ShmControl));
+  st.SetItemsProcessed(static_cast<int64_t>(st.iterations() * items));
+  report_latency(st, hist);
+  st.SetLabel("shm_spsc_two_process");
+}
+BENCHMARK(BM_SPSC_Shm_TwoProcess)->Arg(1<<20)->UseRealTime();
+
+// Baseline: the same message stream over a Unix stream socketpair, one write()
+// and one read() per message.
+static void BM_UnixSocket_TwoProcess(benchmark::State &st) {
+  const std::size_t items = static_cast<std::size_t>(st.range(0));
+  ShmControl *ctl = map_control();
+  if (!ctl) {
+    st.SkipWithError("shared memory unavailable");
+    return;
+  }
+  Hist hist;
+  for (auto _ : perfc::counted(st)) {
+    int fds[2];
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0) {
+      st.SkipWithError("socketpair failed");
+      break;
+    }
+    auto child = [&] {
+      close(fds[0]);
+      run_consumer(ctl, items, 3u, [&](Msg &m) {
+        auto *p = reinterpret_cast<char *>(&m);
+        std::size_t got = 0;
+        while (got < sizeof(Msg)) {
+          const ssize_t r = read(fds[1], p + got, sizeof(Msg) - got);
+          if (r <= 0) return false;
+          got += static_cast<std::size_t>(r);
+        }
+        return true;
+      });
+    };
+    // The parent drops its copy of the consumer's end on the first send (after
+    // the fork), so a dead consumer shows up as EPIPE rather than a write that
+    // blocks forever on a full socket buffer.
+    auto send = [&](const Msg &m, pid_t) {
+      if (fds[1] >= 0) {
+        close(fds[1]);
+        fds[1] = -1;
+      }
+      return ::send(fds[0], &m, sizeof(Msg), MSG_NOSIGNAL) == static_cast<ssize_t>(sizeof(Msg));
+    };
+    const bool ok = run_two_process(st, ctl, items, hist, child, send);
+    close(fds[0]);
+    if (fds[1] >= 0) close(fds[1]);
+    if (!ok) {
+      st.SkipWithError("consumer process failed");
+      break;
+    }
+  }
+  munmap(ctl, sizeof(ShmControl));
+  st.SetItemsProcessed(static_cast<int64_t>(st.iterations() * items));
+  report_latency(st, hist);
+  st.SetLabel("unix_socketpair_two_process");
+}
+BENCHMARK(BM_UnixSocket_TwoProcess)->Arg(1<<18)->UseRealTime();
+
+BENCHMARK_MAIN();
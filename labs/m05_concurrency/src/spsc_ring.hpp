@@ -0,0 +1,176 @@
+#pragma once
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <type_traits>
+
+#include "cache_line.hpp"
+#include "huge_buffer.hpp"
+
+#ifndef NOINLINE
+  #if defined(__clang__) || defined(__GNUC__)
+    #define NOINLINE [[gnu::noinline]]
+  #elif defined(_MSC_VER)
+    #define NOINLINE __declspec(noinline)
+  #else
+    #define NOINLINE
+  #endif
+#endif
+
+// A simple single-producer/single-consumer ring buffer for trivially copyable T.
+// Capacity must be a power of two for mask arithmetic.
+template <class T, std::size_t CapacityPow2>
+struct alignas(kCacheLine) SpscRing {
+  static_assert((CapacityPow2 & (CapacityPow2 - 1)) == 0, "Capacity must be power of two");
+  static_assert(std::is_trivially_copyable_v<T>, "T must be trivially copyable");
+
+  // Avoid false sharing by separating indices to different cache lines.
+  struct alignas(kCacheLine) Index {
+    std::atomic<std::size_t> v{0};
+    char pad[kCacheLine - sizeof(std::atomic<std::size_t>)]{};
+  };
+
+  // Head (write index) and tail (read index)
+  Index head;
+  Index tail;
+
+  // The ring storage itself (not padded).
+  T buf[CapacityPow2];
+
+  static constexpr std::size_t mask = CapacityPow2 - 1;
+
+  NOINLINE bool try_push(const T &x) {
+    // Producer-only code
+    const std::size_t h = head.v.load(std::memory_order_relaxed);
+    const std::size_t t = tail.v.load(std::memory_order_acquire); // observe consumer retirements
+    const std::size_t next = (h + 1) & mask;
+    if (next == t) {
+      return false; // full
+    }
+    // Store payload before publish
+    buf[h] = x;
+    // Publish the new head; release makes payload visible to consumer acquire
+    head.v.store(next, std::memory_order_release);
+    return true;
+  }
+
+  NOINLINE bool try_pop(T &out) {
+    // Consumer-only code
+    const std::size_t t = tail.v.load(std::memory_order_relaxed);
+    const std::size_t h = head.v.load(std::memory_order_acquire); // observe producer publishes
+    if (t == h) {
+      return false; // empty
+    }
+    out = buf[t];
+    const std::size_t next = (t + 1) & mask;
+    // Retire slot
+    tail.v.store(next, std::memory_order_release);
+    return true;
+  }
+
+  // Batch operations: one acquire of the other side's index and one release
+  // publish per call instead of per element (reduces pub/retire overhead).
+  NOINLINE std::size_t push_many(const T *xs, std::size_t n) {
+    const std::size_t h = head.v.load(std::memory_order_relaxed);
+    const std::size_t t = tail.v.load(std::memory_order_acquire);
+    const std::size_t free_slots = (t - h - 1) & mask;
+    const std::size_t k = n < free_slots ? n : free_slots;
+    for (std::size_t i = 0; i < k; ++i) buf[(h + i) & mask] = xs[i];
+    if (k) head.v.store((h + k) & mask, std::memory_order_release);
+    return k;
+  }
+
+  NOINLINE std::size_t pop_many(T *xs, std::size_t n) {
+    const std::size_t t = tail.v.load(std::memory_order_relaxed);
+    const std::size_t h = head.v.load(std::memory_order_acquire);
+    const std::size_t used = (h - t) & mask;
+    const std::size_t k = n < used ? n : used;
+    for (std::size_t i = 0; i < k; ++i) xs[i] = buf[(t + i) & mask];
+    if (k) tail.v.store((t + k) & mask, std::memory_order_release);
+    return k;
+  }
+
+  // Occupancy snapshot; exact only from the producer or consumer thread, an
+  // estimate from anywhere else.
+  std::size_t size_approx() const {
+    return (head.v.load(std::memory_order_relaxed) - tail.v.load(std::memory_order_relaxed)) & mask;
+  }
+};
+
+// Same protocol as SpscRing, but the capacity is chosen at runtime (rounded up
+// to a power of two) and the slots live in a page-aligned mapping that can be
+// huge-page backed. Only the indices and a read-only {buf, mask} line live in
+// the object itself, so it is cheap to place anywhere.
+template <class T>
+class alignas(kCacheLine) DynSpscRing {
+  static_assert(std::is_trivially_copyable_v<T>, "T must be trivially copyable");
+
+public:
+  explicit DynSpscRing(std::size_t capacity, PagePolicy policy = PagePolicy::Default)
+      : storage_(std::bit_ceil(capacity < 2 ? std::size_t{2} : capacity) * sizeof(T), policy),
+        buf_(static_cast<T *>(storage_.data())),
+        mask_(std::bit_ceil(capacity < 2 ? std::size_t{2} : capacity) - 1) {}
+
+  DynSpscRing(const DynSpscRing &) = delete;
+  DynSpscRing &operator=(const DynSpscRing &) = delete;
+
+  NOINLINE bool try_push(const T &x) {
+    const std::size_t h = head_.v.load(std::memory_order_relaxed);
+    const std::size_t t = tail_.v.load(std::memory_order_acquire);
+    const std::size_t next = (h + 1) & mask_;
+    if (next == t) return false; // full
+    buf_[h] = x;
+    head_.v.store(next, std::memory_order_release);
+    return true;
+  }
+
+  NOINLINE bool try_pop(T &out) {
+    const std::size_t t = tail_.v.load(std::memory_order_relaxed);
+    const std::size_t h = head_.v.load(std::memory_order_acquire);
+    if (t == h) return false; // empty
+    out = buf_[t];
+    tail_.v.store((t + 1) & mask_, std::memory_order_release);
+    return true;
+  }
+
+  NOINLINE std::size_t push_many(const T *xs, std::size_t n) {
+    const std::size_t h = head_.v.load(std::memory_order_relaxed);
+    const std::size_t t = tail_.v.load(std::memory_order_acquire);
+    const std::size_t free_slots = (t - h - 1) & mask_;
+    const std::size_t k = n < free_slots ? n : free_slots;
+    for (std::size_t i = 0; i < k; ++i) buf_[(h + i) & mask_] = xs[i];
+    if (k) head_.v.store((h + k) & mask_, std::memory_order_release);
+    return k;
+  }
+
+  NOINLINE std::size_t pop_many(T *xs, std::size_t n) {
+    const std::size_t t = tail_.v.load(std::memory_order_relaxed);
+    const std::size_t h = head_.v.load(std::memory_order_acquire);
+    const std::size_t used = (h - t) & mask_;
+    const std::size_t k = n < used ? n : used;
+    for (std::size_t i = 0; i < k; ++i) xs[i] = buf_[(t + i) & mask_];
+    if (k) tail_.v.store((t + k) & mask_, std::memory_order_release);
+    return k;
+  }
+
+  std::size_t size_approx() const {
+    return (head_.v.load(std::memory_order_relaxed) - tail_.v.load(std::memory_order_relaxed)) & mask_;
+  }
+
+  // Usable slots (one stays empty to tell full from empty).
+  std::size_t capacity() const { return mask_; }
+  PagePolicy backing() const { return storage_.backing(); }
+
+private:
+  struct alignas(kCacheLine) Index {
+    std::atomic<std::size_t> v{0};
+  };
+
+  // Read-only after construction; shared by both sides without contention.
+  HugeBuffer storage_;
+  T *buf_;
+  std::size_t mask_;
+
+  Index head_;
+  Index tail_;
+};
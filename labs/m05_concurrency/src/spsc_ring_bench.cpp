@@ -1,4 +1,5 @@
 #include <benchmark/benchmark.h>
+#include <algorithm>
 #include <atomic>
 #include <cassert>
 #include <cstddef>
@@ -7,14 +8,15 @@
 #include <type_traits>
 #include <vector>
 #include <chrono>
+#include <ctime>
+#include <memory>
 
-#if defined(__clang__) || defined(__GNUC__)
-  #define NOINLINE [[gnu::noinline]]
-#elif defined(_MSC_VER)
-  #define NOINLINE __declspec(noinline)
-#else
-  #define NOINLINE
-#endif
+#include "affinity.hpp"
+#include "backoff.hpp"
+#include "latency_histogram.hpp"
+#include "perf_counters.hpp"
+#include "spsc_ring.hpp"
+#include "trace.hpp"
 
 #if defined(__cpp_lib_hardware_interference_size)
   constexpr std::size_t CLS = std::hardware_destructive_interference_size;
@@ -22,106 +24,56 @@
   constexpr std::size_t CLS = 64;
 #endif
 
-// A simple single-producer/single-consumer ring buffer for trivially copyable T.
-// Capacity must be a power of two for mask arithmetic.
-template <class T, std::size_t CapacityPow2>
-struct alignas(CLS) SpscRing {
-  static_assert((CapacityPow2 & (CapacityPow2 - 1)) == 0, "Capacity must be power of two");
-  static_assert(std::is_trivially_copyable_v<T>, "T must be trivially copyable");
-
-  // Avoid false sharing by separating indices to different cache lines.
-  struct alignas(CLS) Index {
-    std::atomic<std::size_t> v{0};
-    char pad[CLS - sizeof(std::atomic<std::size_t>) > 0 ? CLS - sizeof(std::atomic<std::size_t>) : 1]{};
-  };
-
-  // Head (write index) and tail (read index)
-  Index head;
-  Index tail;
-
-  // The ring storage itself (not padded).
-  T buf[CapacityPow2];
-
-  static constexpr std::size_t mask = CapacityPow2 - 1;
-
-  NOINLINE bool try_push(const T &x) {
-    // Producer-only code
-    const std::size_t h = head.v.load(std::memory_order_relaxed);
-    const std::size_t t = tail.v.load(std::memory_order_acquire); // observe consumer retirements
-    const std::size_t next = (h + 1) & mask;
-    if (next == t) {
-      return false; // full
-    }
-    // Store payload before publish
-    buf[h] = x;
-    // Publish the new head; release makes payload visible to consumer acquire
-    head.v.store(next, std::memory_order_release);
-    return true;
-  }
-
-  NOINLINE bool try_pop(T &out) {
-    // Consumer-only code
-    const std::size_t t = tail.v.load(std::memory_order_relaxed);
-    const std::size_t h = head.v.load(std::memory_order_acquire); // observe producer publishes
-    if (t == h) {
-      return false; // empty
-    }
-    out = buf[t];
-    const std::size_t next = (t + 1) & mask;
-    // Retire slot
-    tail.v.store(next, std::memory_order_release);
-    return true;
-  }
-
-  // Convenience helpers for batch operations (reduce pub/retire overhead)
-  NOINLINE std::size_t push_many(const T *xs, std::size_t n) {
-    std::size_t pushed = 0;
-    while (pushed < n) {
-      if (!try_push(xs[pushed])) break;
-      ++pushed;
-    }
-    return pushed;
-  }
-
-  NOINLINE std::size_t pop_many(T *xs, std::size_t n) {
-    std::size_t popped = 0;
-    while (popped < n) {
-      if (!try_pop(xs[popped])) break;
-      ++popped;
-    }
-    return popped;
-  }
-};
-
-// Producer thread: push count values into the ring.
-template <class RB>
+// Producer thread: push count values into the ring. The backoff policy runs
+// whenever a batch attempt stalls on a full ring (and while waiting to start).
+template <class RB, Backoff B = YieldBackoff>
 NOINLINE void producer(RB *rb, std::size_t count, std::atomic<bool> *start_flag) {
-  // Busy-wait until both threads are ready to start
-  while (!start_flag->load(std::memory_order_acquire)) {}
+  TRACE_THREAD_NAME("producer");
+  B backoff;
+  // Wait until both threads are ready to start
+  while (!start_flag->load(std::memory_order_acquire)) backoff();
+  backoff.reset();
+  TRACE_SCOPE("produce");
+  bool stalled = false; // inside a "ring_full" span
   std::size_t i = 0;
   while (i < count) {
     // Try to batch a few to amortize publish overhead
-    for (int k = 0; k < 8 && i < count; ++k) {
+    int k = 0;
+    for (; k < 8 && i < count; ++k) {
       if (rb->try_push(static_cast<uint32_t>(i))) {
         ++i;
       } else {
         break;
       }
     }
-    // If ring is full, yield briefly
-    if (i < count) std::this_thread::yield();
+    // Ring is full: back off before retrying
+    if (k == 0) {
+      if (!stalled) TRACE_BEGIN("ring_full");
+      stalled = true;
+      backoff();
+    } else {
+      if (stalled) TRACE_END("ring_full");
+      stalled = false;
+      backoff.reset();
+    }
   }
 }
 
 // Consumer thread: pop count values and accumulate (to avoid DCE)
-template <class RB>
+template <class RB, Backoff B = YieldBackoff>
 NOINLINE void consumer(RB *rb, std::size_t count, std::atomic<bool> *start_flag, uint64_t *checksum) {
-  while (!start_flag->load(std::memory_order_acquire)) {}
+  TRACE_THREAD_NAME("consumer");
+  B backoff;
+  while (!start_flag->load(std::memory_order_acquire)) backoff();
+  backoff.reset();
+  TRACE_SCOPE("consume");
+  bool stalled = false; // inside a "ring_empty" span
   std::size_t i = 0;
   uint64_t sum = 0;
   uint32_t val{};
   while (i < count) {
-    for (int k = 0; k < 8 && i < count; ++k) {
+    int k = 0;
+    for (; k < 8 && i < count; ++k) {
       if (rb->try_pop(val)) {
         sum += val;
         ++i;
@@ -129,7 +81,16 @@ NOINLINE void consumer(RB *rb, std::size_t count, std::atomic<bool> *start_flag,
         break;
       }
     }
-    if (i < count) std::this_thread::yield();
+    // Ring is empty: back off before retrying
+    if (k == 0) {
+      if (!stalled) TRACE_BEGIN("ring_empty");
+      stalled = true;
+      backoff();
+    } else {
+      if (stalled) TRACE_END("ring_empty");
+      stalled = false;
+      backoff.reset();
+    }
   }
   *checksum = sum;
 }
@@ -138,17 +99,17 @@ static void BM_SPSC_Ring_Throughput(benchmark::State &st) {
   const std::size_t items = static_cast<std::size_t>(st.range(0));
   // Use a modest ring capacity (power of two). Bigger rings reduce contention.
   using Ring = SpscRing<uint32_t, 1u << 14>; // 16K slots
-  for (auto _ : st) {
-    st.PauseTiming();
-    Ring rb{};
+  for (auto _ : perfc::counted(st)) {
+    perfc::pause_timing(st);
+    auto rb = std::make_unique<Ring>(); // 64KB of slots: keep it off the stack
     std::atomic<bool> start{false};
     uint64_t checksum = 0;
-    std::thread tp(producer<Ring>, &rb, items, &start);
-    std::thread tc(consumer<Ring>, &rb, items, &start, &checksum);
+    std::thread tp(producer<Ring>, rb.get(), items, &start);
+    std::thread tc(consumer<Ring>, rb.get(), items, &start, &checksum);
     // Align start of threads
     auto t0 = std::chrono::steady_clock::now();
     start.store(true, std::memory_order_release);
-    st.ResumeTiming();
+    perfc::resume_timing(st);
 
     tp.join();
     tc.join();
@@ -164,9 +125,211 @@ static void BM_SPSC_Ring_Throughput(benchmark::State &st) {
 }
 BENCHMARK(BM_SPSC_Ring_Throughput)->Arg(1<<20)->Arg(4<<20);
 
+static double process_cpu_seconds() {
+  timespec ts{};
+  clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+  return static_cast<double>(ts.tv_sec) + static_cast<double>(ts.tv_nsec) * 1e-9;
+}
+
+// Same transfer as above, with the producer/consumer wait strategy swapped.
+// cpu_cores is process CPU time over wall time (2.0 = both threads always
+// busy); cpu_ns_per_item charges that CPU to each transferred item.
+template <Backoff B>
+static void BM_SPSC_Ring_Backoff(benchmark::State &st) {
+  const std::size_t items = static_cast<std::size_t>(st.range(0));
+  using Ring = SpscRing<uint32_t, 1u << 14>;
+  auto rb = std::make_unique<Ring>();
+  double wall = 0, cpu = 0;
+  for (auto _ : perfc::counted(st)) {
+    perfc::pause_timing(st);
+    std::atomic<bool> start{false};
+    uint64_t checksum = 0;
+    std::thread tp(producer<Ring, B>, rb.get(), items, &start);
+    std::thread tc(consumer<Ring, B>, rb.get(), items, &start, &checksum);
+    const auto t0 = std::chrono::steady_clock::now();
+    const double c0 = process_cpu_seconds();
+    start.store(true, std::memory_order_release);
+    perfc::resume_timing(st);
+    tp.join();
+    tc.join();
+    cpu += process_cpu_seconds() - c0;
+    wall += std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    benchmark::DoNotOptimize(checksum);
+  }
+  const double total = static_cast<double>(st.iterations()) * static_cast<double>(items);
+  st.SetItemsProcessed(static_cast<int64_t>(total));
+  st.counters["cpu_cores"] = wall > 0 ? cpu / wall : 0.0;
+  st.counters["cpu_ns_per_item"] = cpu * 1e9 / total;
+  st.SetLabel(B::name);
+}
+BENCHMARK_TEMPLATE(BM_SPSC_Ring_Backoff, SpinBackoff)->Arg(1<<20)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_SPSC_Ring_Backoff, PauseBackoff)->Arg(1<<20)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_SPSC_Ring_Backoff, ExpPauseBackoff)->Arg(1<<20)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_SPSC_Ring_Backoff, YieldBackoff)->Arg(1<<20)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_SPSC_Ring_Backoff, SpinThenYield)->Arg(1<<20)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_SPSC_Ring_Backoff, SpinThenPark)->Arg(1<<20)->UseRealTime();
+
+// Runtime-sized ring: Arg(capacity in slots, PagePolicy). The ring is built
+// once per benchmark; only the transfer is timed. Small rings stress the
+// full/empty handoff, large rings stress cache and TLB reach as the producer
+// runs ahead through cold slots. The item count covers the ring at least four
+// times over, so every capacity wraps and every slot is touched.
+static void BM_SPSC_DynRing_Capacity(benchmark::State &st) {
+  const std::size_t capacity = static_cast<std::size_t>(st.range(0));
+  const std::size_t items = std::max<std::size_t>(std::size_t{1} << 22, 4 * capacity);
+  const auto policy = static_cast<PagePolicy>(st.range(1));
+  using Ring = DynSpscRing<uint32_t>;
+  Ring rb(capacity, policy);
+  for (auto _ : perfc::counted(st)) {
+    perfc::pause_timing(st);
+    std::atomic<bool> start{false};
+    uint64_t checksum = 0;
+    std::thread tp(producer<Ring>, &rb, items, &start);
+    std::thread tc(consumer<Ring>, &rb, items, &start, &checksum);
+    start.store(true, std::memory_order_release);
+    perfc::resume_timing(st);
+    tp.join();
+    tc.join();
+    benchmark::DoNotOptimize(checksum);
+  }
+  st.SetItemsProcessed(static_cast<int64_t>(st.iterations() * items));
+  st.counters["ring_bytes"] = static_cast<double>((rb.capacity() + 1) * sizeof(uint32_t));
+  static constexpr const char *kBacking[] = {"4k_pages", "thp_madvise", "hugetlb"};
+  st.SetLabel(kBacking[static_cast<int>(rb.backing())]);
+}
+BENCHMARK(BM_SPSC_DynRing_Capacity)
+    ->ArgsProduct({benchmark::CreateRange(64, 16 << 20, 8),
+                   {static_cast<int64_t>(PagePolicy::Default), static_cast<int64_t>(PagePolicy::TransparentHuge),
+                    static_cast<int64_t>(PagePolicy::ExplicitHuge)}})
+    ->UseRealTime();
+
+// ---------------------------------------------------------------------------
+// Round-trip latency: a client sends timestamps over one ring, an echo thread
+// bounces them back over a second ring, and the client records now - sent into
+// a log-linear histogram. Reported as p50/p90/p99/p99.9/max counters.
+// ---------------------------------------------------------------------------
+
+using PingRing = SpscRing<std::uint64_t, 1u << 10>;
+
+static inline std::uint64_t now_ns() {
+  return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+// Echo side: bounce every message from `in` back on `out` unchanged.
+template <class RB>
+NOINLINE void echo(RB *in, RB *out, std::size_t count, std::atomic<bool> *start_flag, unsigned cpu) {
+  pin_this_thread(cpu);
+  SpinThenYield start_wait;
+  while (!start_flag->load(std::memory_order_acquire)) start_wait();
+  std::uint64_t v{};
+  for (std::size_t i = 0; i < count; ++i) {
+    SpinThenYield wait;
+    while (!in->try_pop(v)) wait();
+    while (!out->try_push(v)) wait();
+  }
+}
+
+// Closed loop: one message in flight; the next send waits for the previous reply.
+template <class RB, class Hist>
+NOINLINE void ping_closed_loop(RB *to, RB *from, std::size_t count, std::atomic<bool> *start_flag,
+                               unsigned cpu, Hist *hist) {
+  pin_this_thread(cpu);
+  SpinThenYield start_wait;
+  while (!start_flag->load(std::memory_order_acquire)) start_wait();
+  std::uint64_t v{};
+  for (std::size_t i = 0; i < count; ++i) {
+    SpinThenYield wait;
+    while (!to->try_push(now_ns())) wait();
+    while (!from->try_pop(v)) wait();
+    hist->record(now_ns() - v);
+  }
+}
+
+// Open loop: sends on a fixed schedule regardless of replies. Latency is measured
+// from the *intended* send time, so a stalled queue is charged for every message
+// it delays (no coordinated omission).
+template <class RB, class Hist>
+NOINLINE void ping_open_loop(RB *to, RB *from, std::size_t count, std::uint64_t interval_ns,
+                             std::atomic<bool> *start_flag, unsigned cpu, Hist *hist) {
+  pin_this_thread(cpu);
+  SpinThenYield start_wait;
+  while (!start_flag->load(std::memory_order_acquire)) start_wait();
+  const std::uint64_t t0 = now_ns();
+  std::size_t sent = 0, received = 0;
+  std::uint64_t v{};
+  SpinThenYield wait;
+  while (received < count) {
+    bool progressed = false;
+    if (sent < count) {
+      const std::uint64_t intended = t0 + sent * interval_ns;
+      if (now_ns() >= intended && to->try_push(intended)) {
+        ++sent;
+        progressed = true;
+      }
+    }
+    if (from->try_pop(v)) {
+      hist->record(now_ns() - v);
+      ++received;
+      progressed = true;
+    }
+    if (!progressed) wait();
+  }
+}
+
+static void BM_SPSC_Ring_PingPong_ClosedLoop(benchmark::State &st) {
+  const std::size_t msgs = static_cast<std::size_t>(st.range(0));
+  auto to = std::make_unique<PingRing>();
+  auto from = std::make_unique<PingRing>();
+  LatencyHistogram<> hist;
+  for (auto _ : perfc::counted(st)) {
+    perfc::pause_timing(st);
+    std::atomic<bool> start{false};
+    std::thread te(echo<PingRing>, to.get(), from.get(), msgs, &start, 3u);
+    std::thread tc(ping_closed_loop<PingRing, LatencyHistogram<>>, to.get(), from.get(), msgs, &start, 2u, &hist);
+    start.store(true, std::memory_order_release);
+    perfc::resume_timing(st);
+    tc.join();
+    te.join();
+  }
+  st.SetItemsProcessed(static_cast<int64_t>(st.iterations() * msgs));
+  report_latency(st, hist);
+  st.SetLabel("spsc_pingpong_closed_loop");
+}
+BENCHMARK(BM_SPSC_Ring_PingPong_ClosedLoop)->Arg(1<<16)->UseRealTime();
+
+// Arg(messages, rate in messages/sec)
+static void BM_SPSC_Ring_PingPong_OpenLoop(benchmark::State &st) {
+  const std::size_t msgs = static_cast<std::size_t>(st.range(0));
+  const std::uint64_t interval_ns = 1'000'000'000ull / static_cast<std::uint64_t>(st.range(1));
+  auto to = std::make_unique<PingRing>();
+  auto from = std::make_unique<PingRing>();
+  LatencyHistogram<> hist;
+  for (auto _ : perfc::counted(st)) {
+    perfc::pause_timing(st);
+    std::atomic<bool> start{false};
+    std::thread te(echo<PingRing>, to.get(), from.get(), msgs, &start, 3u);
+    std::thread tc(ping_open_loop<PingRing, LatencyHistogram<>>, to.get(), from.get(), msgs, interval_ns,
+                   &start, 2u, &hist);
+    start.store(true, std::memory_order_release);
+    perfc::resume_timing(st);
+    tc.join();
+    te.join();
+  }
+  st.SetItemsProcessed(static_cast<int64_t>(st.iterations() * msgs));
+  report_latency(st, hist);
+  st.SetLabel("spsc_pingpong_open_loop");
+}
+BENCHMARK(BM_SPSC_Ring_PingPong_OpenLoop)
+    ->Args({1<<15, 100'000})
+    ->Args({1<<15, 1'000'000})
+    ->UseRealTime();
+
 static void BM_SPSC_Ring_Relaxed_Bug(benchmark::State &st) {
   // A deliberately incorrect variant using relaxed on head publish; only to show TSan catching races.
   const std::size_t items = static_cast<std::size_t>(st.range(0));
+  // Local classes cannot have static data members; the mask lives in the enclosing scope.
+  constexpr std::size_t mask = (1u << 12) - 1;
   struct BadRing {
     struct alignas(CLS) Index {
       std::atomic<std::size_t> v{0};
@@ -174,7 +337,6 @@ static void BM_SPSC_Ring_Relaxed_Bug(benchmark::State &st) {
     };
     Index head, tail;
     uint32_t buf[1u << 12];
-    static constexpr std::size_t mask = (1u << 12) - 1;
 
     bool try_push(uint32_t x) {
       const auto h = head.v.load(std::memory_order_relaxed);
@@ -195,7 +357,7 @@ static void BM_SPSC_Ring_Relaxed_Bug(benchmark::State &st) {
     }
   };
 
-  for (auto _ : st) {
+  for (auto _ : perfc::counted(st)) {
     BadRing rb{};
     std::atomic<bool> start{false};
     uint64_t checksum = 0;
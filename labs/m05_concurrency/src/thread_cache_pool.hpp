@@ -0,0 +1,222 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <mutex>
+#include <new>
+#include <vector>
+
+#include "cache_line.hpp"
+
+// ---------------------------------------------------------------------------
+// Thread-caching size-class allocator in the tcmalloc mould, for objects up
+// to kMaxSize bytes. Larger requests go straight to malloc.
+//
+//   void *p = ThreadCachePool::allocate(96);
+//   ThreadCachePool::deallocate(p, 96);   // sized free: the size picks the class
+//
+// Fast path: a thread-local free list per size class, no atomics at all.
+// A thread that runs dry pulls a batch of kBatch blocks from the class's
+// central list; a thread whose list grows past 2*kBatch pushes a batch back.
+// Central lists hold whole batches, so the lock is taken once per kBatch
+// objects and held for a vector push/pop.
+//
+// Blocks freed by another thread (producer allocates, consumer frees after a
+// queue handoff) simply join the freeing thread's cache and travel back to
+// the allocating thread through the central list, one batch at a time.
+//
+// Slabs are never returned to the OS; a thread's cache is flushed to the
+// central lists when the thread exits.
+// ---------------------------------------------------------------------------
+
+class ThreadCachePool {
+public:
+  static constexpr std::size_t kMaxSize = 4096;
+  static constexpr std::size_t kAlign = 16;
+  static constexpr std::uint32_t kBatch = 32;
+  static constexpr std::size_t kSlabBytes = std::size_t{64} << 10;
+
+  // 16-byte steps up to 256, then four classes per power of two (<= 25% waste).
+  static constexpr std::size_t kClasses = 16 + 4 * 4;
+
+  static constexpr std::size_t class_of(std::size_t bytes) {
+    if (bytes <= 256) return bytes ? (bytes - 1) / 16 : 0;
+    const unsigned e = static_cast<unsigned>(std::bit_width(bytes - 1)); // 2^(e-1) < bytes <= 2^e
+    const std::size_t base = std::size_t{1} << (e - 1);
+    return 16 + (e - 9) * 4 + (bytes - 1 - base) / (base / 4);
+  }
+
+  static constexpr std::size_t class_size(std::size_t c) {
+    if (c < 16) return (c + 1) * 16;
+    const std::size_t base = std::size_t{256} << ((c - 16) / 4);
+    return base + ((c - 16) % 4 + 1) * (base / 4);
+  }
+
+  static void *allocate(std::size_t bytes) {
+    if (bytes > kMaxSize) {
+      if (void *p = std::malloc(bytes)) return p;
+      throw std::bad_alloc();
+    }
+    const std::size_t c = class_of(bytes);
+    ThreadCache &tc = cache();
+    FreeBlock *b = tc.head[c];
+    if (!b) [[unlikely]] {
+      refill(tc, c);
+      b = tc.head[c];
+    }
+    tc.head[c] = b->next;
+    --tc.count[c];
+    return b;
+  }
+
+  static void deallocate(void *p, std::size_t bytes) noexcept {
+    if (!p) return;
+    if (bytes > kMaxSize) {
+      std::free(p);
+      return;
+    }
+    const std::size_t c = class_of(bytes);
+    ThreadCache &tc = cache();
+    auto *b = static_cast<FreeBlock *>(p);
+    b->next = tc.head[c];
+    tc.head[c] = b;
+    if (++tc.count[c] >= 2 * kBatch) [[unlikely]] release_batch(tc, c);
+  }
+
+  // Slow-path counters: batches moved between thread caches and central lists.
+  struct Stats {
+    std::uint64_t refills;
+    std::uint64_t flushes;
+    std::uint64_t slabs;
+  };
+  static Stats stats() {
+    const Shared &s = shared();
+    return {s.refills.load(std::memory_order_relaxed), s.flushes.load(std::memory_order_relaxed),
+            s.slabs.load(std::memory_order_relaxed)};
+  }
+
+private:
+  struct FreeBlock {
+    FreeBlock *next;
+  };
+  struct Batch {
+    FreeBlock *head;
+    std::uint32_t count;
+  };
+
+  struct alignas(kCacheLine) Central {
+    std::mutex mu;
+    std::vector<Batch> batches;
+  };
+
+  struct Shared {
+    std::array<Central, kClasses> central;
+    alignas(kCacheLine) std::atomic<std::uint64_t> refills{0};
+    std::atomic<std::uint64_t> flushes{0};
+    std::atomic<std::uint64_t> slabs{0};
+  };
+
+  struct ThreadCache {
+    std::array<FreeBlock *, kClasses> head{};
+    std::array<std::uint32_t, kClasses> count{};
+    ThreadCache() { shared(); } // see shared()
+    ~ThreadCache() {
+      for (std::size_t c = 0; c < kClasses; ++c) {
+        if (head[c]) push_central(c, {head[c], count[c]});
+      }
+    }
+  };
+
+  // Function-local statics. Each ThreadCache constructor touches shared()
+  // first, so the shared state finishes construction before any thread cache
+  // does and is destroyed after all of them, including the main thread's,
+  // whose destructor flushes into the central lists at exit.
+  static Shared &shared() {
+    static Shared s;
+    return s;
+  }
+  static ThreadCache &cache() {
+    thread_local ThreadCache tc;
+    return tc;
+  }
+
+  static void push_central(std::size_t c, Batch b) {
+    Central &cl = shared().central[c];
+    std::lock_guard lk(cl.mu);
+    cl.batches.push_back(b);
+  }
+
+  static void refill(ThreadCache &tc, std::size_t c) {
+    Shared &s = shared();
+    s.refills.fetch_add(1, std::memory_order_relaxed);
+    {
+      Central &cl = s.central[c];
+      std::lock_guard lk(cl.mu);
+      if (!cl.batches.empty()) {
+        const Batch b = cl.batches.back();
+        cl.batches.pop_back();
+        tc.head[c] = b.head;
+        tc.count[c] = b.count;
+        return;
+      }
+    }
+    // Central list empty: carve a fresh slab. The first batch goes straight
+    // to this thread, the rest to the central list.
+    const std::size_t size = class_size(c);
+    const std::size_t n = std::max<std::size_t>(kSlabBytes / size, kBatch);
+    auto *slab = static_cast<std::byte *>(std::aligned_alloc(kAlign, n * size));
+    if (!slab) throw std::bad_alloc();
+    s.slabs.fetch_add(1, std::memory_order_relaxed);
+    std::vector<Batch> carved;
+    for (std::size_t i = 0; i < n; i += kBatch) {
+      const std::size_t k = std::min<std::size_t>(kBatch, n - i);
+      for (std::size_t j = 0; j < k; ++j) {
+        auto *b = reinterpret_cast<FreeBlock *>(slab + (i + j) * size);
+        b->next = j + 1 < k ? reinterpret_cast<FreeBlock *>(slab + (i + j + 1) * size) : nullptr;
+      }
+      carved.push_back({reinterpret_cast<FreeBlock *>(slab + i * size), static_cast<std::uint32_t>(k)});
+    }
+    tc.head[c] = carved.front().head;
+    tc.count[c] = carved.front().count;
+    Central &cl = s.central[c];
+    std::lock_guard lk(cl.mu);
+    cl.batches.insert(cl.batches.end(), carved.begin() + 1, carved.end());
+  }
+
+  // Cut kBatch blocks off the front of the thread list and hand them back.
+  static void release_batch(ThreadCache &tc, std::size_t c) {
+    shared().flushes.fetch_add(1, std::memory_order_relaxed);
+    FreeBlock *first = tc.head[c];
+    FreeBlock *last = first;
+    for (std::uint32_t i = 1; i < kBatch; ++i) last = last->next;
+    tc.head[c] = last->next;
+    tc.count[c] -= kBatch;
+    last->next = nullptr;
+    push_central(c, {first, kBatch});
+  }
+};
+
+static_assert(ThreadCachePool::class_of(1) == 0 && ThreadCachePool::class_of(16) == 0 &&
+              ThreadCachePool::class_of(17) == 1 && ThreadCachePool::class_of(256) == 15 &&
+              ThreadCachePool::class_of(257) == 16 && ThreadCachePool::class_of(320) == 16 &&
+              ThreadCachePool::class_of(512) == 19 && ThreadCachePool::class_of(4096) == 31);
+static_assert(ThreadCachePool::class_size(15) == 256 && ThreadCachePool::class_size(16) == 320 &&
+              ThreadCachePool::class_size(19) == 512 && ThreadCachePool::class_size(31) == 4096);
+
+// std::allocator-compatible front end, so containers and strings can draw
+// from the pool (stateless: all instances are interchangeable).
+template <class T>
+struct PoolAllocator {
+  using value_type = T;
+  PoolAllocator() = default;
+  template <class U>
+  PoolAllocator(const PoolAllocator<U> &) noexcept {}
+  T *allocate(std::size_t n) { return static_cast<T *>(ThreadCachePool::allocate(n * sizeof(T))); }
+  void deallocate(T *p, std::size_t n) noexcept { ThreadCachePool::deallocate(p, n * sizeof(T)); }
+  template <class U>
+  bool operator==(const PoolAllocator<U> &) const noexcept { return true; }
+};
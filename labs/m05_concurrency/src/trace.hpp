@@ -0,0 +1,239 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+  #include <x86intrin.h>
+#endif
+#if defined(__linux__)
+  #include <unistd.h>
+#endif
+
+#include "cache_line.hpp"
+
+// Per-thread trace recorder with Chrome / Perfetto JSON export.
+//
+//   TRACE_THREAD_NAME("producer");
+//   TRACE_SCOPE("transfer");          // begin here, end at the closing brace
+//   TRACE_BEGIN("ring_full"); ... TRACE_END("ring_full");
+//   TRACE_INSTANT("poll");
+//
+// Each thread appends {TSC, event id, phase} to its own ring of
+// TRACE_BUFFER_EVENTS slots: no atomics, no locks, no allocation on the
+// recording path (the first event on a thread registers its buffer). When a
+// ring wraps, the oldest events are overwritten, so a trace keeps the tail
+// of each thread's run. Buffers outlive their threads; once more than
+// TRACE_MAX_BUFFERS exist, a new thread recycles the buffer of the thread
+// that exited first. Benchmarks that spawn threads per iteration therefore
+// keep the last few iterations.
+//
+// At process exit the trace is written to $TRACE_OUT (default trace.json);
+// open it in ui.perfetto.dev or chrome://tracing. Exporting reads the buffers
+// without synchronization: it must run after the recording threads have been
+// joined, as it does at exit.
+//
+// Without TRACE_ENABLED=1 the macros expand to nothing. Call sites may keep
+// bookkeeping for spans (a bool for "stall in progress"); with tracing
+// compiled out it is dead and the optimizer drops it.
+
+#ifndef TRACE_BUFFER_EVENTS
+  #define TRACE_BUFFER_EVENTS (1u << 16)
+#endif
+#ifndef TRACE_MAX_BUFFERS
+  #define TRACE_MAX_BUFFERS 64
+#endif
+
+namespace trace {
+
+enum class Phase : std::uint8_t { Begin, End, Instant };
+
+struct Event {
+  std::uint64_t tsc;
+  std::uint32_t id;
+  Phase phase;
+};
+static_assert(sizeof(Event) == 16);
+
+inline std::uint64_t timestamp() {
+#if defined(__x86_64__) || defined(__i386__)
+  return __rdtsc();
+#else
+  return static_cast<std::uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+}
+
+struct alignas(kCacheLine) ThreadBuffer {
+  static constexpr std::size_t capacity = TRACE_BUFFER_EVENTS;
+  static_assert((capacity & (capacity - 1)) == 0, "TRACE_BUFFER_EVENTS must be a power of two");
+
+  std::uint64_t next = 0; // events ever written; slot = next % capacity
+  std::uint32_t tid = 0;
+  const char *name = nullptr;
+  std::unique_ptr<Event[]> events{new Event[capacity]};
+};
+
+class Registry {
+public:
+  static Registry &get() {
+    static Registry r;
+    return r;
+  }
+
+  std::uint32_t intern(const char *name) {
+    std::lock_guard lk(mu_);
+    names_.push_back(name);
+    return static_cast<std::uint32_t>(names_.size() - 1);
+  }
+
+  ThreadBuffer *attach() {
+    std::lock_guard lk(mu_);
+    ThreadBuffer *b;
+    if (buffers_.size() >= TRACE_MAX_BUFFERS && !retired_.empty()) {
+      b = retired_.front();
+      retired_.pop_front();
+      b->next = 0;
+      b->name = nullptr;
+    } else {
+      buffers_.push_back(std::make_unique<ThreadBuffer>());
+      b = buffers_.back().get();
+    }
+    b->tid = ++last_tid_;
+    return b;
+  }
+
+  void retire(ThreadBuffer *b) {
+    std::lock_guard lk(mu_);
+    retired_.push_back(b);
+  }
+
+  // Chrome trace-event JSON ("B"/"E"/"i" events plus thread names).
+  // Ends whose begin was overwritten by the ring are dropped.
+  bool write_chrome_json(const char *path) {
+    std::lock_guard lk(mu_);
+    std::FILE *f = std::fopen(path, "w");
+    if (!f) return false;
+    const double ticks_per_us = calibrate();
+#if defined(__linux__)
+    const long pid = static_cast<long>(getpid());
+#else
+    const long pid = 1;
+#endif
+    std::fprintf(f, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n");
+    const char *sep = "";
+    for (const auto &b : buffers_) {
+      if (b->next == 0) continue;
+      if (b->name) {
+        std::fprintf(f, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%ld,\"tid\":%u,\"args\":{\"name\":\"%s\"}}",
+                     sep, pid, b->tid, b->name);
+        sep = ",\n";
+      }
+      const std::uint64_t first = b->next > ThreadBuffer::capacity ? b->next - ThreadBuffer::capacity : 0;
+      unsigned depth = 0;
+      for (std::uint64_t i = first; i < b->next; ++i) {
+        const Event &e = b->events[i & (ThreadBuffer::capacity - 1)];
+        if (e.phase == Phase::End && depth == 0) continue;
+        depth += e.phase == Phase::Begin;
+        depth -= e.phase == Phase::End;
+        static constexpr const char *kPh[] = {"B", "E", "i"};
+        const double ts = static_cast<double>(e.tsc - origin_tsc_) / ticks_per_us;
+        std::fprintf(f, "%s{\"name\":\"%s\",\"ph\":\"%s\",\"ts\":%.3f,\"pid\":%ld,\"tid\":%u%s}", sep,
+                     names_[e.id], kPh[static_cast<int>(e.phase)], ts, pid, b->tid,
+                     e.phase == Phase::Instant ? ",\"s\":\"t\"" : "");
+        sep = ",\n";
+      }
+    }
+    std::fprintf(f, "\n]}\n");
+    return std::fclose(f) == 0;
+  }
+
+private:
+  Registry() : origin_tsc_(timestamp()), origin_clock_(std::chrono::steady_clock::now()) {}
+
+  ~Registry() {
+    const char *path = std::getenv("TRACE_OUT");
+    if (!path || !*path) path = "trace.json";
+    if (write_chrome_json(path)) std::fprintf(stderr, "trace: wrote %s\n", path);
+    else std::fprintf(stderr, "trace: cannot write %s\n", path);
+  }
+
+  // Timestamp ticks per microsecond, measured against steady_clock over the
+  // whole run (at least 10 ms of it).
+  double calibrate() const {
+    using namespace std::chrono;
+    while (steady_clock::now() - origin_clock_ < milliseconds(10)) {}
+    const std::uint64_t t = timestamp();
+    const double us = duration<double, std::micro>(steady_clock::now() - origin_clock_).count();
+    return static_cast<double>(t - origin_tsc_) / us;
+  }
+
+  std::mutex mu_;
+  std::vector<const char *> names_;
+  std::vector<std::unique_ptr<ThreadBuffer>> buffers_;
+  std::deque<ThreadBuffer *> retired_;
+  std::uint32_t last_tid_ = 0;
+  std::uint64_t origin_tsc_;
+  std::chrono::steady_clock::time_point origin_clock_;
+};
+
+// Hot path state: a trivially destructible thread_local is a plain %fs load;
+// the retiring guard (non-trivial destructor) is touched once per thread.
+inline thread_local ThreadBuffer *tls_buffer = nullptr;
+
+[[gnu::noinline, gnu::cold]] inline ThreadBuffer *attach_this_thread() {
+  struct Retire {
+    ~Retire() {
+      if (tls_buffer) Registry::get().retire(tls_buffer);
+    }
+  };
+  static thread_local Retire guard;
+  (void)&guard;
+  tls_buffer = Registry::get().attach();
+  return tls_buffer;
+}
+
+inline void emit(std::uint32_t id, Phase phase) {
+  ThreadBuffer *b = tls_buffer;
+  if (__builtin_expect(b == nullptr, 0)) b = attach_this_thread();
+  b->events[b->next & (ThreadBuffer::capacity - 1)] = Event{timestamp(), id, phase};
+  ++b->next;
+}
+
+inline void set_thread_name(const char *name) {
+  ThreadBuffer *b = tls_buffer ? tls_buffer : attach_this_thread();
+  b->name = name;
+}
+
+struct Scope {
+  std::uint32_t id;
+  explicit Scope(std::uint32_t i) : id(i) { emit(id, Phase::Begin); }
+  ~Scope() { emit(id, Phase::End); }
+  Scope(const Scope &) = delete;
+  Scope &operator=(const Scope &) = delete;
+};
+
+} // namespace trace
+
+#if defined(TRACE_ENABLED) && TRACE_ENABLED
+  // One id per call site, interned on first use (a guard check afterwards).
+  // Names must be string literals: the registry keeps the pointer.
+  #define TRACE_ID_(name) ([]() -> std::uint32_t { static const std::uint32_t id = ::trace::Registry::get().intern(name); return id; }())
+  #define TRACE_CAT2_(a, b) a##b
+  #define TRACE_CAT_(a, b) TRACE_CAT2_(a, b)
+  #define TRACE_BEGIN(name) ::trace::emit(TRACE_ID_(name), ::trace::Phase::Begin)
+  #define TRACE_END(name) ::trace::emit(TRACE_ID_(name), ::trace::Phase::End)
+  #define TRACE_INSTANT(name) ::trace::emit(TRACE_ID_(name), ::trace::Phase::Instant)
+  #define TRACE_SCOPE(name) ::trace::Scope TRACE_CAT_(trace_scope_, __LINE__)(TRACE_ID_(name))
+  #define TRACE_THREAD_NAME(name) ::trace::set_thread_name(name)
+#else
+  #define TRACE_BEGIN(name) static_cast<void>(0)
+  #define TRACE_END(name) static_cast<void>(0)
+  #define TRACE_INSTANT(name) static_cast<void>(0)
+  #define TRACE_SCOPE(name) static_cast<void>(0)
+  #define TRACE_THREAD_NAME(name) static_cast<void>(0)
+#endif
@@ -0,0 +1,168 @@
+#include <benchmark/benchmark.h>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "perf_counters.hpp"
+#include "work_stealing_pool.hpp"
+
+#if defined(__clang__) || defined(__GNUC__)
+  #define NOINLINE [[gnu::noinline]]
+#elif defined(_MSC_VER)
+  #define NOINLINE __declspec(noinline)
+#else
+  #define NOINLINE
+#endif
+
+// ---------------------------------------------------------------------------
+// Workloads
+// ---------------------------------------------------------------------------
+
+NOINLINE std::uint64_t fib_serial(unsigned n) { return n < 2 ? n : fib_serial(n - 1) + fib_serial(n - 2); }
+
+// Fork-join fib: fork n-1, compute n-2 inline, join. Below the cutoff the
+// recursion runs serially so task overhead does not swamp the work.
+template <class Pool>
+std::uint64_t fib_tasks(Pool &pool, unsigned n, unsigned cutoff) {
+  if (n <= cutoff) return fib_serial(n);
+  std::uint64_t a = 0;
+  TaskGroup<Pool> g(pool);
+  g.run([&pool, &a, n, cutoff] { a = fib_tasks(pool, n - 1, cutoff); });
+  const std::uint64_t b = fib_tasks(pool, n - 2, cutoff);
+  g.wait();
+  return a + b;
+}
+
+// Unbalanced tree in the style of UTS (Unbalanced Tree Search): every node
+// derives its child count from a hash of its id, so the shape is deterministic
+// but subtree sizes vary wildly. Static partitioning of the root's children
+// leaves most threads idle while one walks a deep subtree.
+static inline std::uint64_t mix(std::uint64_t x) {
+  x ^= x >> 33;
+  x *= 0xff51afd7ed558ccdull;
+  x ^= x >> 33;
+  x *= 0xc4ceb9fe1a85ec53ull;
+  x ^= x >> 33;
+  return x;
+}
+
+static inline unsigned tree_children(std::uint64_t id, unsigned depth) {
+  if (depth == 0) return 0;
+  // Binomial-ish: most nodes are leaves, a few have many children.
+  const std::uint64_t h = mix(id);
+  return (h % 4 == 0) ? 1 + static_cast<unsigned>((h >> 8) % 12) : 0;
+}
+
+// A little per-node work so the tree walk is compute- not allocation-bound.
+// Walkers return the sum of node_work over the tree as a checksum.
+static inline std::uint64_t node_work(std::uint64_t id) {
+  std::uint64_t x = id;
+  for (int i = 0; i < 64; ++i) x = mix(x);
+  return x & 0xff;
+}
+
+static std::uint64_t tree_size(std::uint64_t id, unsigned depth) {
+  std::uint64_t count = 1;
+  const unsigned kids = tree_children(id, depth);
+  for (unsigned k = 0; k < kids; ++k) count += tree_size(mix(id + k + 1), depth - 1);
+  return count;
+}
+
+NOINLINE std::uint64_t tree_serial(std::uint64_t id, unsigned depth) {
+  std::uint64_t sum = node_work(id);
+  const unsigned kids = tree_children(id, depth);
+  for (unsigned k = 0; k < kids; ++k) sum += tree_serial(mix(id + k + 1), depth - 1);
+  return sum;
+}
+
+template <class Pool>
+std::uint64_t tree_tasks(Pool &pool, std::uint64_t id, unsigned depth) {
+  const unsigned kids = tree_children(id, depth);
+  if (kids == 0) return node_work(id);
+  std::vector<std::uint64_t> sub(kids, 0);
+  {
+    TaskGroup<Pool> g(pool);
+    for (unsigned k = 1; k < kids; ++k) {
+      g.run([&pool, &sub, id, k, depth] { sub[k] = tree_tasks(pool, mix(id + k + 1), depth - 1); });
+    }
+    sub[0] = tree_tasks(pool, mix(id + 1), depth - 1);
+    g.wait();
+  }
+  std::uint64_t sum = node_work(id);
+  for (auto c : sub) sum += c;
+  return sum;
+}
+
+// Root picked by scanning seeds for a tree of roughly half a million nodes.
+constexpr std::uint64_t kTreeRoot = 1;
+constexpr unsigned kTreeDepth = 24;
+
+// ---------------------------------------------------------------------------
+// Benchmarks. Arg(threads)
+// ---------------------------------------------------------------------------
+
+constexpr unsigned kFibN = 32;
+constexpr unsigned kFibCutoff = 14;
+
+static void BM_Fib_Serial(benchmark::State &st) {
+  for (auto _ : perfc::counted(st)) benchmark::DoNotOptimize(fib_serial(kFibN));
+  st.SetLabel("fib_serial");
+}
+BENCHMARK(BM_Fib_Serial)->UseRealTime();
+
+template <class Pool>
+static void BM_Fib(benchmark::State &st) {
+  Pool pool(static_cast<unsigned>(st.range(0)));
+  std::uint64_t r = 0;
+  for (auto _ : perfc::counted(st)) {
+    r = fib_tasks(pool, kFibN, kFibCutoff);
+    benchmark::DoNotOptimize(r);
+  }
+  if (r != fib_serial(kFibN)) st.SkipWithError("fib mismatch");
+}
+BENCHMARK_TEMPLATE(BM_Fib, WorkStealingPool)->Arg(1)->Arg(2)->Arg(4)->Arg(8)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_Fib, SharedQueuePool)->Arg(1)->Arg(2)->Arg(4)->Arg(8)->UseRealTime();
+
+static void BM_Tree_Serial(benchmark::State &st) {
+  for (auto _ : perfc::counted(st)) benchmark::DoNotOptimize(tree_serial(kTreeRoot, kTreeDepth));
+  st.counters["nodes"] = benchmark::Counter(static_cast<double>(tree_size(kTreeRoot, kTreeDepth)));
+  st.SetLabel("tree_serial");
+}
+BENCHMARK(BM_Tree_Serial)->UseRealTime();
+
+template <class Pool>
+static void BM_Tree(benchmark::State &st) {
+  Pool pool(static_cast<unsigned>(st.range(0)));
+  std::uint64_t sum = 0;
+  for (auto _ : perfc::counted(st)) {
+    sum = tree_tasks(pool, kTreeRoot, kTreeDepth);
+    benchmark::DoNotOptimize(sum);
+  }
+  if (sum != tree_serial(kTreeRoot, kTreeDepth)) st.SkipWithError("tree checksum mismatch");
+  st.counters["nodes"] = benchmark::Counter(static_cast<double>(tree_size(kTreeRoot, kTreeDepth)));
+}
+BENCHMARK_TEMPLATE(BM_Tree, WorkStealingPool)->Arg(1)->Arg(2)->Arg(4)->Arg(8)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_Tree, SharedQueuePool)->Arg(1)->Arg(2)->Arg(4)->Arg(8)->UseRealTime();
+
+// Irregular parallel_for: element i costs O(i) work, so equal-sized static
+// chunks finish at very different times (the last chunk does the most).
+template <class Pool>
+static void BM_ParallelFor_Irregular(benchmark::State &st) {
+  Pool pool(static_cast<unsigned>(st.range(0)));
+  constexpr std::size_t N = 1u << 14;
+  std::vector<std::uint64_t> out(N);
+  for (auto _ : perfc::counted(st)) {
+    parallel_for(pool, 0, N, 64, [&out](std::size_t i) {
+      std::uint64_t x = i;
+      for (std::size_t k = 0; k < (i >> 4); ++k) x = mix(x);
+      out[i] = x;
+    });
+    benchmark::DoNotOptimize(out.data());
+    benchmark::ClobberMemory();
+  }
+}
+BENCHMARK_TEMPLATE(BM_ParallelFor_Irregular, WorkStealingPool)->Arg(1)->Arg(2)->Arg(4)->Arg(8)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_ParallelFor_Irregular, SharedQueuePool)->Arg(1)->Arg(2)->Arg(4)->Arg(8)->UseRealTime();
+
+BENCHMARK_MAIN();
@@ -0,0 +1,353 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "cache_line.hpp"
+
+// ---------------------------------------------------------------------------
+// Chase-Lev work-stealing deque (Lê, Pop, Cohen, Zappa Nardelli, PPoPP'13 C11
+// formulation). The owner pushes and pops at the bottom without a CAS except
+// when racing a thief for the last element; thieves CAS the top. The buffer
+// grows by doubling; retired buffers are kept until the deque dies because a
+// concurrent thief may still be reading from them.
+// ---------------------------------------------------------------------------
+template <class T>
+class ChaseLevDeque {
+  static_assert(std::is_trivially_copyable_v<T>, "T must be trivially copyable (typically a pointer)");
+
+  struct Array {
+    explicit Array(std::int64_t cap) : capacity(cap), slots(new std::atomic<T>[static_cast<std::size_t>(cap)]) {}
+    T get(std::int64_t i) const { return slots[static_cast<std::size_t>(i & (capacity - 1))].load(std::memory_order_relaxed); }
+    void put(std::int64_t i, T x) { slots[static_cast<std::size_t>(i & (capacity - 1))].store(x, std::memory_order_relaxed); }
+
+    std::int64_t capacity;
+    std::unique_ptr<std::atomic<T>[]> slots;
+  };
+
+public:
+  explicit ChaseLevDeque(std::int64_t initial_capacity = 256) {
+    const auto cap = std::bit_ceil(static_cast<std::uint64_t>(std::max<std::int64_t>(initial_capacity, 2)));
+    auto a = std::make_unique<Array>(static_cast<std::int64_t>(cap));
+    array_.store(a.get(), std::memory_order_relaxed);
+    arrays_.push_back(std::move(a));
+  }
+  ChaseLevDeque(const ChaseLevDeque &) = delete;
+  ChaseLevDeque &operator=(const ChaseLevDeque &) = delete;
+
+  // Owner only.
+  void push(T x) {
+    const std::int64_t b = bottom_.load(std::memory_order_relaxed);
+    const std::int64_t t = top_.load(std::memory_order_acquire);
+    Array *a = array_.load(std::memory_order_relaxed);
+    if (b - t > a->capacity - 1) a = grow(a, b, t);
+    a->put(b, x);
+    std::atomic_thread_fence(std::memory_order_release);
+    bottom_.store(b + 1, std::memory_order_relaxed);
+  }
+
+  // Owner only. LIFO end: the most recently pushed (hottest) task.
+  std::optional<T> pop() {
+    const std::int64_t b = bottom_.load(std::memory_order_relaxed) - 1;
+    Array *a = array_.load(std::memory_order_relaxed);
+    bottom_.store(b, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    std::int64_t t = top_.load(std::memory_order_relaxed);
+    if (t > b) { // empty
+      bottom_.store(b + 1, std::memory_order_relaxed);
+      return std::nullopt;
+    }
+    T x = a->get(b);
+    if (t == b) {
+      // Last element: race thieves for it through top.
+      const bool won = top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+      bottom_.store(b + 1, std::memory_order_relaxed);
+      if (!won) return std::nullopt;
+    }
+    return x;
+  }
+
+  // Any thread. FIFO end: the oldest (usually largest) task.
+  std::optional<T> steal() {
+    std::int64_t t = top_.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    const std::int64_t b = bottom_.load(std::memory_order_acquire);
+    if (t >= b) return std::nullopt;
+    Array *a = array_.load(std::memory_order_acquire);
+    T x = a->get(t);
+    if (!top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+      return std::nullopt; // lost to the owner or another thief
+    }
+    return x;
+  }
+
+  std::int64_t size_approx() const {
+    return std::max<std::int64_t>(0, bottom_.load(std::memory_order_relaxed) - top_.load(std::memory_order_relaxed));
+  }
+
+private:
+  Array *grow(Array *old, std::int64_t b, std::int64_t t) {
+    auto a = std::make_unique<Array>(old->capacity * 2);
+    for (std::int64_t i = t; i < b; ++i) a->put(i, old->get(i));
+    Array *raw = a.get();
+    arrays_.push_back(std::move(a)); // owner-only list; old arrays stay alive for thieves
+    array_.store(raw, std::memory_order_release);
+    return raw;
+  }
+
+  alignas(kCacheLine) std::atomic<std::int64_t> top_{0};
+  alignas(kCacheLine) std::atomic<std::int64_t> bottom_{0};
+  std::atomic<Array *> array_{nullptr};
+  std::vector<std::unique_ptr<Array>> arrays_;
+};
+
+// ---------------------------------------------------------------------------
+// Type-erased task. Pools move Task* around; TaskGroup owns completion.
+// ---------------------------------------------------------------------------
+struct Task {
+  void (*invoke)(Task *);
+};
+
+// Fork-join scope: run() forks a task onto the pool, wait() joins by helping
+// to execute queued work until every task forked through this group finished.
+// Waiting threads never block, so nested fork-join cannot deadlock the pool.
+template <class Pool>
+class TaskGroup {
+public:
+  explicit TaskGroup(Pool &pool) : pool_(pool) {}
+  TaskGroup(const TaskGroup &) = delete;
+  TaskGroup &operator=(const TaskGroup &) = delete;
+  ~TaskGroup() { wait(); }
+
+  template <class F>
+  void run(F &&f) {
+    pending_.fetch_add(1, std::memory_order_relaxed);
+    pool_.submit(new Impl<std::decay_t<F>>(std::forward<F>(f), this));
+  }
+
+  void wait() {
+    unsigned idle = 0;
+    while (pending_.load(std::memory_order_acquire) != 0) {
+      if (pool_.try_run_one()) {
+        idle = 0;
+      } else if (++idle > 64) {
+        std::this_thread::yield();
+      }
+    }
+  }
+
+private:
+  template <class F>
+  struct Impl : Task {
+    Impl(F fn, TaskGroup *g) : Task{&Impl::call}, f(std::move(fn)), group(g) {}
+    static void call(Task *t) {
+      auto *self = static_cast<Impl *>(t);
+      self->f();
+      TaskGroup *g = self->group;
+      delete self;
+      g->pending_.fetch_sub(1, std::memory_order_release);
+    }
+    F f;
+    TaskGroup *group;
+  };
+
+  Pool &pool_;
+  std::atomic<std::size_t> pending_{0};
+};
+
+// Recursive range splitting: halves are forked until a chunk is <= grain, so
+// idle workers steal large halves first and the load balances itself.
+template <class Pool, class F>
+void parallel_for(Pool &pool, std::size_t begin, std::size_t end, std::size_t grain, const F &body) {
+  grain = std::max<std::size_t>(grain, 1);
+  if (end - begin <= grain) {
+    for (std::size_t i = begin; i < end; ++i) body(i);
+    return;
+  }
+  const std::size_t mid = begin + (end - begin) / 2;
+  TaskGroup<Pool> g(pool);
+  g.run([&pool, mid, end, grain, &body] { parallel_for(pool, mid, end, grain, body); });
+  parallel_for(pool, begin, mid, grain, body);
+  g.wait();
+}
+
+// ---------------------------------------------------------------------------
+// Work-stealing pool: one Chase-Lev deque per worker. Workers pop their own
+// deque (LIFO, cache-warm), then steal from random victims (FIFO, big chunks),
+// then drain the injection queue fed by non-worker threads. After a run of
+// failed attempts a worker parks on a condition variable with a short timeout.
+// ---------------------------------------------------------------------------
+class WorkStealingPool {
+public:
+  explicit WorkStealingPool(unsigned threads = std::max(1u, std::thread::hardware_concurrency())) {
+    queues_.reserve(threads);
+    for (unsigned i = 0; i < threads; ++i) queues_.push_back(std::make_unique<ChaseLevDeque<Task *>>());
+    workers_.reserve(threads);
+    for (unsigned i = 0; i < threads; ++i) workers_.emplace_back([this, i] { worker_loop(i); });
+  }
+  WorkStealingPool(const WorkStealingPool &) = delete;
+  WorkStealingPool &operator=(const WorkStealingPool &) = delete;
+
+  ~WorkStealingPool() {
+    stop_.store(true, std::memory_order_release);
+    cv_.notify_all();
+    for (auto &w : workers_) w.join();
+  }
+
+  unsigned size() const { return static_cast<unsigned>(workers_.size()); }
+
+  void submit(Task *t) {
+    if (tl_pool == this) {
+      queues_[tl_index]->push(t);
+    } else {
+      std::lock_guard lk(inject_mu_);
+      inject_.push_back(t);
+    }
+    if (sleepers_.load(std::memory_order_relaxed) > 0) cv_.notify_one();
+  }
+
+  // Run one queued task on the calling thread, if any can be found.
+  bool try_run_one() {
+    Task *t = find_task();
+    if (!t) return false;
+    t->invoke(t);
+    return true;
+  }
+
+private:
+  Task *find_task() {
+    const bool is_worker = tl_pool == this;
+    if (is_worker) {
+      if (auto t = queues_[tl_index]->pop()) return *t;
+    }
+    const unsigned n = size();
+    std::uint64_t &rng = tl_rng;
+    for (unsigned attempt = 0; attempt < n; ++attempt) {
+      rng ^= rng << 13;
+      rng ^= rng >> 7;
+      rng ^= rng << 17;
+      const unsigned victim = static_cast<unsigned>(rng % n);
+      if (is_worker && victim == tl_index) continue;
+      if (auto t = queues_[victim]->steal()) return *t;
+    }
+    std::lock_guard lk(inject_mu_);
+    if (inject_.empty()) return nullptr;
+    Task *t = inject_.front();
+    inject_.pop_front();
+    return t;
+  }
+
+  void worker_loop(unsigned index) {
+    tl_pool = this;
+    tl_index = index;
+    tl_rng = 0x9E3779B97F4A7C15ull * (index + 1);
+    unsigned misses = 0;
+    while (!stop_.load(std::memory_order_acquire)) {
+      if (try_run_one()) {
+        misses = 0;
+        continue;
+      }
+      if (++misses < 64) {
+        std::this_thread::yield();
+        continue;
+      }
+      sleepers_.fetch_add(1, std::memory_order_relaxed);
+      {
+        std::unique_lock lk(sleep_mu_);
+        cv_.wait_for(lk, std::chrono::milliseconds(1));
+      }
+      sleepers_.fetch_sub(1, std::memory_order_relaxed);
+      misses = 0;
+    }
+  }
+
+  static inline thread_local WorkStealingPool *tl_pool = nullptr;
+  static inline thread_local unsigned tl_index = 0;
+  static inline thread_local std::uint64_t tl_rng = 0x2545F4914F6CDD1Dull;
+
+  std::vector<std::unique_ptr<ChaseLevDeque<Task *>>> queues_;
+  std::vector<std::thread> workers_;
+  std::mutex inject_mu_;
+  std::deque<Task *> inject_;
+  std::mutex sleep_mu_;
+  std::condition_variable cv_;
+  std::atomic<int> sleepers_{0};
+  std::atomic<bool> stop_{false};
+};
+
+// ---------------------------------------------------------------------------
+// Baseline: every worker and every fork goes through one mutex-protected FIFO.
+// ---------------------------------------------------------------------------
+class SharedQueuePool {
+public:
+  explicit SharedQueuePool(unsigned threads = std::max(1u, std::thread::hardware_concurrency())) {
+    workers_.reserve(threads);
+    for (unsigned i = 0; i < threads; ++i) workers_.emplace_back([this] { worker_loop(); });
+  }
+  SharedQueuePool(const SharedQueuePool &) = delete;
+  SharedQueuePool &operator=(const SharedQueuePool &) = delete;
+
+  ~SharedQueuePool() {
+    {
+      std::lock_guard lk(mu_);
+      stop_ = true;
+    }
+    cv_.notify_all();
+    for (auto &w : workers_) w.join();
+  }
+
+  unsigned size() const { return static_cast<unsigned>(workers_.size()); }
+
+  void submit(Task *t) {
+    {
+      std::lock_guard lk(mu_);
+      q_.push_back(t);
+    }
+    cv_.notify_one();
+  }
+
+  bool try_run_one() {
+    Task *t = nullptr;
+    {
+      std::lock_guard lk(mu_);
+      if (q_.empty()) return false;
+      t = q_.front();
+      q_.pop_front();
+    }
+    t->invoke(t);
+    return true;
+  }
+
+private:
+  void worker_loop() {
+    for (;;) {
+      Task *t = nullptr;
+      {
+        std::unique_lock lk(mu_);
+        cv_.wait(lk, [this] { return stop_ || !q_.empty(); });
+        if (stop_ && q_.empty()) return;
+        t = q_.front();
+        q_.pop_front();
+      }
+      t->invoke(t);
+    }
+  }
+
+  std::vector<std::thread> workers_;
+  std::mutex mu_;
+  std::condition_variable cv_;
+  std::deque<Task *> q_;
+  bool stop_ = false;
+};
@@ -0,0 +1,88 @@
+// axpy_sum.hpp — sum(a[i] * x[i] + y[i]): the single-accumulator kernel from
+// kernel_ir.cpp and multi-accumulator variants that vectorize without
+// -ffast-math.
+//
+// axpy_sum has one loop-carried dependency through acc, and the compiler may
+// not reorder float additions, so it runs at one add per FP-add latency. The
+// variants below spell out a different, fixed order that exposes L
+// independent chains the vectorizer can map onto SIMD lanes:
+//   - element i is added to acc[i % L], in increasing i;
+//   - the L accumulators are then folded pairwise: at w = L/2, L/4, ..., 1,
+//     acc[l] += acc[l + w] for l < w; the result is acc[0].
+// The order depends on L only, not on n's alignment or the vector width.
+//
+// The term a*x + y is left to the compiler in axpy_sum and axpy_sum_lanes:
+// GCC's default (-ffp-contract=fast in GNU mode) fuses it into one fma, while
+// -ffp-contract=off rounds the product first. axpy_sum_fma makes the fusion
+// explicit, so its result is the same under either setting.
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+
+inline float axpy_sum(const float* a, const float* x, const float* y, std::size_t n) {
+  float acc = 0.0f;
+  for (std::size_t i = 0; i < n; ++i) {
+    acc += a[i] * x[i] + y[i];
+  }
+  return acc;
+}
+
+namespace axpy_detail {
+inline constexpr std::size_t kBlock = 256;
+
+template <bool Fused>
+inline float term(float a, float x, float y) {
+  if constexpr (Fused) return std::fma(a, x, y);
+  else return a * x + y;
+}
+
+// Two loop shapes, same order. With L at least as wide as the vector GCC
+// picks (8 floats on AVX targets) the direct loop keeps each accumulator
+// vector in a register. A narrower L in that loop gets vectorized across
+// groups and every lane then reduced in order, slower than axpy_sum; for it,
+// terms go a block at a time through a stack buffer and are added lane-wise,
+// as in compute_kernel_vm.
+inline constexpr std::size_t kDirectMinLanes = 8;
+
+template <std::size_t L, bool Fused>
+inline float sum_lanes(const float* a, const float* x, const float* y, std::size_t n) {
+  static_assert(L > 0 && (L & (L - 1)) == 0 && kBlock % L == 0, "lane count must be a power of two <= kBlock");
+  float acc[L] = {};
+  if constexpr (L >= kDirectMinLanes) {
+    std::size_t i = 0;
+    for (; i + L <= n; i += L) {
+      for (std::size_t l = 0; l < L; ++l) acc[l] += term<Fused>(a[i + l], x[i + l], y[i + l]);
+    }
+    for (std::size_t l = 0; i < n; ++i, ++l) acc[l] += term<Fused>(a[i], x[i], y[i]);
+  } else {
+    float t[kBlock];
+    for (std::size_t i = 0; i < n; i += kBlock) {
+      const std::size_t m = n - i < kBlock ? n - i : kBlock;
+      for (std::size_t j = 0; j < m; ++j) t[j] = term<Fused>(a[i + j], x[i + j], y[i + j]);
+      if (m == kBlock) {
+        for (std::size_t b = 0; b < kBlock; b += L) {
+          for (std::size_t l = 0; l < L; ++l) acc[l] += t[b + l];
+        }
+      } else {
+        for (std::size_t j = 0; j < m; ++j) acc[j % L] += t[j];
+      }
+    }
+  }
+  for (std::size_t w = L / 2; w > 0; w /= 2) {
+    for (std::size_t l = 0; l < w; ++l) acc[l] += acc[l + w];
+  }
+  return acc[0];
+}
+} // namespace axpy_detail
+
+template <std::size_t L>
+inline float axpy_sum_lanes(const float* a, const float* x, const float* y, std::size_t n) {
+  return axpy_detail::sum_lanes<L, false>(a, x, y, n);
+}
+
+// Same order; each term is fma(a, x, y), rounded once.
+template <std::size_t L>
+inline float axpy_sum_fma(const float* a, const float* x, const float* y, std::size_t n) {
+  return axpy_detail::sum_lanes<L, true>(a, x, y, n);
+}
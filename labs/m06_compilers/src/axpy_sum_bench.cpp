@@ -0,0 +1,68 @@
+// axpy_sum_bench.cpp — Single vs multi-accumulator axpy_sum, no fast-math
+// Build target: axpy_sum_bench
+
+#include <benchmark/benchmark.h>
+#include <cstddef>
+#include <random>
+#include <vector>
+
+#include "axpy_sum.hpp"
+#include "perf_counters.hpp"
+
+#if defined(__clang__) || defined(__GNUC__)
+  #define NOINLINE [[gnu::noinline]]
+#elif defined(_MSC_VER)
+  #define NOINLINE __declspec(noinline)
+#else
+  #define NOINLINE
+#endif
+
+using Kernel = float (*)(const float*, const float*, const float*, std::size_t);
+
+struct Inputs {
+  std::vector<float> a, x, y;
+  explicit Inputs(std::size_t n) : a(n), x(n), y(n) {
+    std::mt19937 rng(123);
+    std::uniform_real_distribution<float> dist(0.0f, 1.0f);
+    for (std::size_t i = 0; i < n; ++i) {
+      a[i] = dist(rng);
+      x[i] = dist(rng);
+      y[i] = dist(rng);
+    }
+  }
+};
+
+// Out of line, so each variant is compiled as its own loop rather than inlined
+// into (and re-costed with) the benchmark body.
+NOINLINE float acc_1(const float* a, const float* x, const float* y, std::size_t n) { return axpy_sum(a, x, y, n); }
+NOINLINE float lanes_4(const float* a, const float* x, const float* y, std::size_t n) { return axpy_sum_lanes<4>(a, x, y, n); }
+NOINLINE float lanes_8(const float* a, const float* x, const float* y, std::size_t n) { return axpy_sum_lanes<8>(a, x, y, n); }
+NOINLINE float lanes_16(const float* a, const float* x, const float* y, std::size_t n) { return axpy_sum_lanes<16>(a, x, y, n); }
+NOINLINE float fma_4(const float* a, const float* x, const float* y, std::size_t n) { return axpy_sum_fma<4>(a, x, y, n); }
+NOINLINE float fma_8(const float* a, const float* x, const float* y, std::size_t n) { return axpy_sum_fma<8>(a, x, y, n); }
+NOINLINE float fma_16(const float* a, const float* x, const float* y, std::size_t n) { return axpy_sum_fma<16>(a, x, y, n); }
+
+template <Kernel K>
+static void BM_AxpySum(benchmark::State& st) {
+  const auto n = static_cast<std::size_t>(st.range(0));
+  const Inputs in(n);
+  for (auto _ : perfc::counted(st)) {
+    float s = K(in.a.data(), in.x.data(), in.y.data(), n);
+    benchmark::DoNotOptimize(s);
+  }
+  st.SetItemsProcessed(static_cast<int64_t>(st.iterations() * n));
+  st.SetBytesProcessed(static_cast<int64_t>(st.iterations() * n * 3 * sizeof(float)));
+}
+
+// 48 KiB (L1/L2), 768 KiB (L2/L3), 12 MiB (DRAM-ish) of input
+#define AXPY_ARGS Arg(1 << 12)->Arg(1 << 16)->Arg(1 << 20)->ArgName("n")
+
+BENCHMARK_TEMPLATE(BM_AxpySum, acc_1)->AXPY_ARGS;
+BENCHMARK_TEMPLATE(BM_AxpySum, lanes_4)->AXPY_ARGS;
+BENCHMARK_TEMPLATE(BM_AxpySum, lanes_8)->AXPY_ARGS;
+BENCHMARK_TEMPLATE(BM_AxpySum, lanes_16)->AXPY_ARGS;
+BENCHMARK_TEMPLATE(BM_AxpySum, fma_4)->AXPY_ARGS;
+BENCHMARK_TEMPLATE(BM_AxpySum, fma_8)->AXPY_ARGS;
+BENCHMARK_TEMPLATE(BM_AxpySum, fma_16)->AXPY_ARGS;
+
+BENCHMARK_MAIN();
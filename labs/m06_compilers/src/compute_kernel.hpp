@@ -0,0 +1,64 @@
+// compute_kernel.hpp — The fast-math study kernel, in its libm form and on
+// top of vec_math.hpp.
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+
+#include "vec_math.hpp"
+
+// Kernel uses operations impacted by fast-math: reassociation, reciprocal approx, FMA opportunities.
+inline float compute_kernel(const float* x, std::size_t n) {
+  float sum = 0.0f;
+  for (std::size_t i = 0; i < n; ++i) {
+    float v = x[i];
+    // Mix of transcendental, sqrt, and reciprocal to highlight differences.
+    float t1 = std::sin(v) * std::cos(v);
+    float t2 = std::sqrt(v + 1.0f);
+    float t3 = 1.0f / (v + 1.0f);
+    // Encourage FMA by a*b + c pattern
+    sum += t1 * t2 + t3;
+  }
+  return sum;
+}
+
+// Same math through vmath, vectorizable under strict IEEE semantics.
+// The sum runs in kKernelLanes independent accumulators (element i goes to
+// lane i % kKernelLanes, in increasing i), folded pairwise at the end: a fixed
+// order, so the result does not depend on the vector width the compiler picks
+// or on -ffp-contract. It differs from compute_kernel's left-to-right sum by
+// reassociation error only.
+//
+// Terms are produced a block at a time into a stack buffer (a flat map loop
+// the vectorizer always takes), then added lane-wise.
+inline constexpr std::size_t kKernelLanes = 16;
+inline constexpr std::size_t kKernelBlock = 256; // multiple of kKernelLanes
+
+inline float compute_kernel_term(float v) {
+  float s, c;
+  vmath::sincos(v, s, c);
+  const float t1 = s * c;
+  const float t2 = vmath::sqrt(v + 1.0f);
+  const float t3 = vmath::rcp(v + 1.0f);
+  return std::fma(t1, t2, t3);
+}
+
+inline float compute_kernel_vm(const float* x, std::size_t n) {
+  float acc[kKernelLanes] = {};
+  float t[kKernelBlock];
+  for (std::size_t i = 0; i < n; i += kKernelBlock) {
+    const std::size_t m = n - i < kKernelBlock ? n - i : kKernelBlock;
+    for (std::size_t j = 0; j < m; ++j) t[j] = compute_kernel_term(x[i + j]);
+    if (m == kKernelBlock) {
+      for (std::size_t b = 0; b < kKernelBlock; b += kKernelLanes) {
+        for (std::size_t l = 0; l < kKernelLanes; ++l) acc[l] += t[b + l];
+      }
+    } else {
+      for (std::size_t j = 0; j < m; ++j) acc[j % kKernelLanes] += t[j];
+    }
+  }
+  for (std::size_t w = kKernelLanes / 2; w > 0; w /= 2) {
+    for (std::size_t l = 0; l < w; ++l) acc[l] += acc[l + w];
+  }
+  return acc[0];
+}
@@ -0,0 +1,49 @@
+// fastmath_demo_bench.cpp — fastmath_demo's kernels under Google Benchmark
+// Build target: fastmath_demo_bench
+//
+// fastmath_demo times one cold call at millisecond resolution; this sweeps
+// n = 1<<10 .. 1<<24 (4 KiB .. 64 MiB of input) with a warmup and five
+// repetitions per size, and reports mean/median/stddev/cv.
+
+#include <benchmark/benchmark.h>
+#include <cstddef>
+#include <random>
+#include <vector>
+
+#include "compute_kernel.hpp"
+#include "perf_counters.hpp"
+
+constexpr std::size_t kMaxN = 1u << 24;
+
+// One shared input; each size reads a prefix of it.
+static const std::vector<float>& input() {
+  static const std::vector<float> x = [] {
+    std::vector<float> v(kMaxN);
+    std::mt19937 rng(123);
+    std::uniform_real_distribution<float> dist(0.0f, 1.0f);
+    for (auto& e : v) e = dist(rng);
+    return v;
+  }();
+  return x;
+}
+
+template <float (*K)(const float*, std::size_t)>
+static void BM_Kernel(benchmark::State& st) {
+  const auto n = static_cast<std::size_t>(st.range(0));
+  const float* x = input().data();
+  for (auto _ : perfc::counted(st)) {
+    float s = K(x, n);
+    benchmark::DoNotOptimize(s);
+  }
+  st.SetItemsProcessed(static_cast<int64_t>(st.iterations() * n));
+  st.SetBytesProcessed(static_cast<int64_t>(st.iterations() * n * sizeof(float)));
+}
+
+#define SWEEP_ARGS                                                                                          \
+  RangeMultiplier(4)->Range(1 << 10, 1 << 24)->ArgName("n")->MinWarmUpTime(0.05)->Repetitions(5)         \
+      ->DisplayAggregatesOnly(true)
+
+BENCHMARK_TEMPLATE(BM_Kernel, compute_kernel)->SWEEP_ARGS;
+BENCHMARK_TEMPLATE(BM_Kernel, compute_kernel_vm)->SWEEP_ARGS;
+
+BENCHMARK_MAIN();
@@ -0,0 +1,237 @@
+// fastmath_harness.cpp — ULP histograms and ns/element for one fast-math policy
+// Linked into: fastmath_precise, fastmath_fast_math, fastmath_no_errno,
+//              fastmath_fp_contract
+//
+// Always built precise (-ffp-contract=off, no fast-math): the long-double
+// references and the error arithmetic must not inherit the policy under test.
+// Only fastmath_kernels.cpp changes between the executables.
+//
+// Output: a ULP table over a sweep of float bit patterns, then Google
+// Benchmark results with ns/element and the kernel's max ULP error as
+// counters, so one JSON line carries both sides of the trade.
+//
+// Flags (before the --benchmark_* ones):
+//   --ulp_exhaustive    every float in each domain (slow: ~10^9 per kernel)
+//   --ulp_samples=N     stratified sweep, N floats per kernel (default 1<<22)
+//
+// Things to look for: -fno-math-errno alone turns sqrt into vsqrtps (same
+// 0.5 ulp); -ffast-math also vectorizes sin/cos through libmvec and replaces
+// sqrt and 1/x with estimate + Newton (~2 ulp), and reassociates the vm
+// reduction; -ffp-contract=fast only touches the libm-form term. vmath
+// elementwise results are identical in all four builds.
+
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "fastmath_kernels.hpp"
+#include "perf_counters.hpp"
+
+namespace {
+
+using Unary = void (*)(const float*, float*, std::size_t);
+using Reduce = float (*)(const float*, std::size_t);
+
+long double ref_sin(long double v) { return sinl(v); }
+long double ref_cos(long double v) { return cosl(v); }
+long double ref_sqrt(long double v) { return sqrtl(v); }
+long double ref_rcp(long double v) { return 1.0L / v; }
+long double ref_term(long double v) { return sinl(v) * cosl(v) * sqrtl(v + 1.0L) + 1.0L / (v + 1.0L); }
+
+struct Kernel {
+  const char* name;
+  Unary fn;
+  long double (*ref)(long double);
+  float ulp_lo, ulp_hi;     // ULP sweep domain (positive; sin is odd, cos even)
+  float bench_lo, bench_hi; // benchmark inputs, uniform
+  double max_ulp = 0;       // filled by the sweep
+};
+
+// Benchmark domains follow vec_math_bench: compute_kernel's [0, 1) and the
+// [1, 2) its sqrt/rcp arguments land in. Sweep domains are wider and stop at
+// vmath's documented limits.
+Kernel g_kernels[] = {
+    {"sin", k_sin, ref_sin, 0x1p-20f, 64.0f, -8.0f, 8.0f},
+    {"vm_sin", k_vm_sin, ref_sin, 0x1p-20f, 64.0f, -8.0f, 8.0f},
+    {"cos", k_cos, ref_cos, 0x1p-20f, 64.0f, -8.0f, 8.0f},
+    {"vm_cos", k_vm_cos, ref_cos, 0x1p-20f, 64.0f, -8.0f, 8.0f},
+    {"sqrt", k_sqrt, ref_sqrt, 0x1p-60f, 0x1p60f, 1.0f, 2.0f},
+    {"vm_sqrt", k_vm_sqrt, ref_sqrt, 0x1p-60f, 0x1p60f, 1.0f, 2.0f},
+    {"rcp", k_rcp, ref_rcp, 0x1p-60f, 0x1p60f, 1.0f, 2.0f},
+    {"vm_rcp", k_vm_rcp, ref_rcp, 0x1p-60f, 0x1p60f, 1.0f, 2.0f},
+    {"term", k_term, ref_term, 0x1p-20f, 1.0f, 0.0f, 1.0f},
+    {"vm_term", k_vm_term, ref_term, 0x1p-20f, 1.0f, 0.0f, 1.0f},
+};
+
+struct Reduction {
+  const char* name;
+  Reduce fn;
+  double rel_err = 0; // filled by the check
+};
+
+Reduction g_reductions[] = {
+    {"compute_kernel", k_compute_kernel},
+    {"compute_kernel_vm", k_compute_kernel_vm},
+};
+
+// Error of y in units of the float spacing at the reference value: <= 0.5 is
+// correctly rounded. The spacing is taken at |ref| rounded down to a power of
+// two, so values just above a binade boundary are not scored against the
+// wider spacing of the binade above.
+long double ulp_error(float y, long double ref) {
+  if (ref == 0.0L) return y == 0.0f ? 0.0L : INFINITY;
+  int e;
+  frexpl(fabsl(ref), &e);
+  const long double spacing = ldexpl(1.0L, std::max(e - 24, -149));
+  return fabsl(static_cast<long double>(y) - ref) / spacing;
+}
+
+// Buckets: <= 0.5, 1, 2, 4, 16, 1024 ulp, then everything above.
+constexpr long double kBucketEdges[] = {0.5L, 1.0L, 2.0L, 4.0L, 16.0L, 1024.0L};
+constexpr std::size_t kBuckets = std::size(kBucketEdges) + 1;
+
+struct Histogram {
+  std::uint64_t count[kBuckets] = {};
+  std::uint64_t total = 0;
+  long double max = 0;
+  float argmax = 0;
+
+  void add(float x, long double err) {
+    std::size_t b = 0;
+    while (b < std::size(kBucketEdges) && !(err <= kBucketEdges[b])) ++b;
+    ++count[b];
+    ++total;
+    if (!(err <= max)) {
+      max = err;
+      argmax = x;
+    }
+  }
+};
+
+// Walks the float bit patterns from lo to hi with a fixed stride: every
+// binade gets the same share of samples, which is the stratification that
+// matters for ULP error (it is relative to the binade, not to |x|).
+Histogram sweep(const Kernel& k, std::uint64_t samples) {
+  const std::uint32_t lo = std::bit_cast<std::uint32_t>(k.ulp_lo);
+  const std::uint32_t hi = std::bit_cast<std::uint32_t>(k.ulp_hi);
+  const std::uint64_t span = hi - lo;
+  const std::uint64_t stride = samples == 0 || samples >= span ? 1 : span / samples;
+
+  constexpr std::size_t kChunk = 4096;
+  std::vector<float> x(kChunk), y(kChunk);
+  Histogram h;
+  for (std::uint64_t u = lo; u < hi;) {
+    std::size_t m = 0;
+    for (; m < kChunk && u < hi; ++m, u += stride) x[m] = std::bit_cast<float>(static_cast<std::uint32_t>(u));
+    k.fn(x.data(), y.data(), m);
+    for (std::size_t i = 0; i < m; ++i) h.add(x[i], ulp_error(y[i], k.ref(x[i])));
+  }
+  return h;
+}
+
+void print_ulp_table(std::uint64_t samples) {
+  std::printf("policy: %s\n", kPolicyName);
+  std::printf("%-10s %11s %9s %9s %9s %9s %9s %9s %9s %10s %14s\n", "kernel", "samples", "<=0.5", "<=1", "<=2",
+              "<=4", "<=16", "<=1024", ">1024", "max_ulp", "at_x");
+  for (auto& k : g_kernels) {
+    const Histogram h = sweep(k, samples);
+    k.max_ulp = static_cast<double>(h.max);
+    std::printf("%-10s %11llu", k.name, static_cast<unsigned long long>(h.total));
+    for (auto c : h.count) std::printf(" %8.4f%%", 100.0 * static_cast<double>(c) / static_cast<double>(h.total));
+    std::printf(" %10.3Lg %14.8g\n", h.max, static_cast<double>(h.argmax));
+  }
+}
+
+constexpr std::size_t kN = 1u << 16; // 256 KiB per array: L2-resident
+
+std::vector<float> make_input(float lo, float hi) {
+  std::vector<float> x(kN);
+  std::mt19937 rng(123);
+  std::uniform_real_distribution<float> dist(lo, hi);
+  for (auto& v : x) v = dist(rng);
+  return x;
+}
+
+// Reductions are scored by relative error of the sum over the benchmark
+// input: reassociation shows up here, not in the per-element sweep.
+void print_reduction_table() {
+  const auto x = make_input(0.0f, 1.0f);
+  long double ref = 0;
+  for (float v : x) ref += ref_term(v);
+  std::printf("%-18s %14s %14s %10s\n", "reduction", "result", "reference", "rel_err");
+  for (auto& r : g_reductions) {
+    const float s = r.fn(x.data(), kN);
+    r.rel_err = static_cast<double>(fabsl(static_cast<long double>(s) - ref) / fabsl(ref));
+    std::printf("%-18s %14.6f %14.6Lf %10.3g\n", r.name, static_cast<double>(s), ref, r.rel_err);
+  }
+  std::printf("\n");
+}
+
+// ns/element is the inverted per-element rate; the console prints it with an
+// SI prefix (time_per_elem=1.2ns), JSON in seconds.
+void set_counters(benchmark::State& st) {
+  st.SetItemsProcessed(static_cast<int64_t>(st.iterations() * kN));
+  st.counters["time_per_elem"] =
+      benchmark::Counter(static_cast<double>(kN), benchmark::Counter::kIsIterationInvariantRate |
+                                                      benchmark::Counter::kInvert);
+}
+
+void BM_Unary(benchmark::State& st, const Kernel* k) {
+  const auto x = make_input(k->bench_lo, k->bench_hi);
+  std::vector<float> y(kN);
+  for (auto _ : perfc::counted(st)) {
+    k->fn(x.data(), y.data(), kN);
+    benchmark::DoNotOptimize(y.data());
+    benchmark::ClobberMemory();
+  }
+  set_counters(st);
+  st.counters["max_ulp"] = k->max_ulp;
+  st.SetLabel(kPolicyName);
+}
+
+void BM_Reduce(benchmark::State& st, const Reduction* r) {
+  const auto x = make_input(0.0f, 1.0f);
+  for (auto _ : perfc::counted(st)) {
+    float s = r->fn(x.data(), kN);
+    benchmark::DoNotOptimize(s);
+  }
+  set_counters(st);
+  st.counters["rel_err"] = r->rel_err;
+  st.SetLabel(kPolicyName);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  std::uint64_t samples = 1u << 22;
+  int out = 1;
+  for (int i = 1; i < argc; ++i) {
+    if (std::strcmp(argv[i], "--ulp_exhaustive") == 0) {
+      samples = 0;
+    } else if (std::strncmp(argv[i], "--ulp_samples=", 14) == 0) {
+      samples = std::strtoull(argv[i] + 14, nullptr, 10);
+    } else {
+      argv[out++] = argv[i];
+    }
+  }
+  argc = out;
+
+  print_ulp_table(samples);
+  print_reduction_table();
+
+  for (const auto& k : g_kernels) benchmark::RegisterBenchmark(k.name, BM_Unary, &k);
+  for (const auto& r : g_reductions) benchmark::RegisterBenchmark(r.name, BM_Reduce, &r);
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) return 1;
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+  return 0;
+}
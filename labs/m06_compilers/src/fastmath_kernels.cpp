@@ -0,0 +1,50 @@
+// fastmath_kernels.cpp — The math kernels, built under one fast-math policy
+// Build targets: fastmath_precise, fastmath_fast_math, fastmath_no_errno,
+//                fastmath_fp_contract (same source, different flags)
+
+#include <cmath>
+#include <cstddef>
+
+#include "compute_kernel.hpp"
+#include "fastmath_kernels.hpp"
+#include "vec_math.hpp"
+
+#ifndef FASTMATH_POLICY
+  #define FASTMATH_POLICY "unknown"
+#endif
+
+const char* const kPolicyName = FASTMATH_POLICY;
+
+void k_sin(const float* x, float* y, std::size_t n) {
+  for (std::size_t i = 0; i < n; ++i) y[i] = std::sin(x[i]);
+}
+void k_cos(const float* x, float* y, std::size_t n) {
+  for (std::size_t i = 0; i < n; ++i) y[i] = std::cos(x[i]);
+}
+void k_sqrt(const float* x, float* y, std::size_t n) {
+  for (std::size_t i = 0; i < n; ++i) y[i] = std::sqrt(x[i]);
+}
+void k_rcp(const float* x, float* y, std::size_t n) {
+  for (std::size_t i = 0; i < n; ++i) y[i] = 1.0f / x[i];
+}
+void k_term(const float* x, float* y, std::size_t n) {
+  for (std::size_t i = 0; i < n; ++i) {
+    const float v = x[i];
+    y[i] = std::sin(v) * std::cos(v) * std::sqrt(v + 1.0f) + 1.0f / (v + 1.0f);
+  }
+}
+
+void k_vm_sin(const float* x, float* y, std::size_t n) {
+  for (std::size_t i = 0; i < n; ++i) y[i] = vmath::sin(x[i]);
+}
+void k_vm_cos(const float* x, float* y, std::size_t n) {
+  for (std::size_t i = 0; i < n; ++i) y[i] = vmath::cos(x[i]);
+}
+void k_vm_sqrt(const float* x, float* y, std::size_t n) { vmath::sqrt(x, y, n); }
+void k_vm_rcp(const float* x, float* y, std::size_t n) { vmath::rcp(x, y, n); }
+void k_vm_term(const float* x, float* y, std::size_t n) {
+  for (std::size_t i = 0; i < n; ++i) y[i] = compute_kernel_term(x[i]);
+}
+
+float k_compute_kernel(const float* x, std::size_t n) { return compute_kernel(x, n); }
+float k_compute_kernel_vm(const float* x, std::size_t n) { return compute_kernel_vm(x, n); }
@@ -0,0 +1,29 @@
+// fastmath_kernels.hpp — Kernels compiled once per fast-math policy.
+//
+// fastmath_kernels.cpp is built into one executable per policy (precise,
+// -ffast-math, -fno-math-errno, -ffp-contract=fast) and linked against the
+// harness in fastmath_harness.cpp, which is always built precise: the
+// reference values and the ULP bookkeeping must not inherit the flags under
+// test.
+#pragma once
+
+#include <cstddef>
+
+// Name of the policy this executable's kernels were built with.
+extern const char* const kPolicyName;
+
+// Elementwise: y[i] = f(x[i]).
+void k_sin(const float* x, float* y, std::size_t n);
+void k_cos(const float* x, float* y, std::size_t n);
+void k_sqrt(const float* x, float* y, std::size_t n);
+void k_rcp(const float* x, float* y, std::size_t n);
+void k_term(const float* x, float* y, std::size_t n);    // compute_kernel's summand, libm form
+void k_vm_sin(const float* x, float* y, std::size_t n);
+void k_vm_cos(const float* x, float* y, std::size_t n);
+void k_vm_sqrt(const float* x, float* y, std::size_t n);
+void k_vm_rcp(const float* x, float* y, std::size_t n);
+void k_vm_term(const float* x, float* y, std::size_t n); // compute_kernel_term
+
+// Reductions.
+float k_compute_kernel(const float* x, std::size_t n);
+float k_compute_kernel_vm(const float* x, std::size_t n);
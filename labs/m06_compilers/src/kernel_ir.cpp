@@ -5,13 +5,16 @@
 #include <random>
 #include <iostream>
 
-// A small kernel suitable for IR reading/vectorization study
-float axpy_sum(const float* a, const float* x, const float* y, std::size_t n) {
-  float acc = 0.0f;
-  for (std::size_t i = 0; i < n; ++i) {
-    acc += a[i] * x[i] + y[i];
-  }
-  return acc;
+#include "axpy_sum.hpp"
+
+// Small kernels suitable for IR reading/vectorization study (axpy_sum.hpp);
+// kernel_ir_bench times them.
+// Out-of-line instances so each shows up as its own function in the IR/asm.
+[[gnu::noinline]] float axpy_sum_8(const float* a, const float* x, const float* y, std::size_t n) {
+  return axpy_sum_lanes<8>(a, x, y, n);
+}
+[[gnu::noinline]] float axpy_sum_fma_16(const float* a, const float* x, const float* y, std::size_t n) {
+  return axpy_sum_fma<16>(a, x, y, n);
 }
 
 int main() {
@@ -27,5 +30,7 @@ int main() {
   }
   float s = axpy_sum(a.data(), x.data(), y.data(), N);
   std::cout << s << "\n";
+  std::cout << axpy_sum_8(a.data(), x.data(), y.data(), N) << "\n";
+  std::cout << axpy_sum_fma_16(a.data(), x.data(), y.data(), N) << "\n";
   return 0;
 }
\ No newline at end of file
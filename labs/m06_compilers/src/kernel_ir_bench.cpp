@@ -0,0 +1,70 @@
+// kernel_ir_bench.cpp — kernel_ir's axpy_sum kernels under Google Benchmark
+// Build target: kernel_ir_bench
+//
+// Same kernels as the kernel_ir binary (which stays the IR/asm study
+// target), swept over n = 1<<10 .. 1<<24 (12 KiB .. 192 MiB of input) with a
+// warmup and five repetitions per size. axpy_sum_bench has every lane count.
+
+#include <benchmark/benchmark.h>
+#include <cstddef>
+#include <random>
+#include <vector>
+
+#include "axpy_sum.hpp"
+#include "perf_counters.hpp"
+
+#if defined(__clang__) || defined(__GNUC__)
+  #define NOINLINE [[gnu::noinline]]
+#elif defined(_MSC_VER)
+  #define NOINLINE __declspec(noinline)
+#else
+  #define NOINLINE
+#endif
+
+constexpr std::size_t kMaxN = 1u << 24;
+
+struct Inputs {
+  std::vector<float> a, x, y;
+};
+
+// One shared input set; each size reads a prefix of it.
+static const Inputs& inputs() {
+  static const Inputs in = [] {
+    Inputs v{std::vector<float>(kMaxN), std::vector<float>(kMaxN), std::vector<float>(kMaxN)};
+    std::mt19937 rng(123);
+    std::uniform_real_distribution<float> dist(0.0f, 1.0f);
+    for (std::size_t i = 0; i < kMaxN; ++i) {
+      v.a[i] = dist(rng);
+      v.x[i] = dist(rng);
+      v.y[i] = dist(rng);
+    }
+    return v;
+  }();
+  return in;
+}
+
+NOINLINE float acc_1(const float* a, const float* x, const float* y, std::size_t n) { return axpy_sum(a, x, y, n); }
+NOINLINE float lanes_8(const float* a, const float* x, const float* y, std::size_t n) { return axpy_sum_lanes<8>(a, x, y, n); }
+NOINLINE float fma_16(const float* a, const float* x, const float* y, std::size_t n) { return axpy_sum_fma<16>(a, x, y, n); }
+
+template <float (*K)(const float*, const float*, const float*, std::size_t)>
+static void BM_AxpySum(benchmark::State& st) {
+  const auto n = static_cast<std::size_t>(st.range(0));
+  const Inputs& in = inputs();
+  for (auto _ : perfc::counted(st)) {
+    float s = K(in.a.data(), in.x.data(), in.y.data(), n);
+    benchmark::DoNotOptimize(s);
+  }
+  st.SetItemsProcessed(static_cast<int64_t>(st.iterations() * n));
+  st.SetBytesProcessed(static_cast<int64_t>(st.iterations() * n * 3 * sizeof(float)));
+}
+
+#define SWEEP_ARGS                                                                                          \
+  RangeMultiplier(4)->Range(1 << 10, 1 << 24)->ArgName("n")->MinWarmUpTime(0.05)->Repetitions(5)         \
+      ->DisplayAggregatesOnly(true)
+
+BENCHMARK_TEMPLATE(BM_AxpySum, acc_1)->SWEEP_ARGS;
+BENCHMARK_TEMPLATE(BM_AxpySum, lanes_8)->SWEEP_ARGS;
+BENCHMARK_TEMPLATE(BM_AxpySum, fma_16)->SWEEP_ARGS;
+
+BENCHMARK_MAIN();
@@ -0,0 +1,55 @@
+// parallel_kernel.hpp — Multi-threaded compute_kernel whose result does not
+// depend on the thread count.
+//
+// Floating-point addition is not associative, so a parallel sum is only
+// reproducible if the order of every addition is fixed before the work is
+// handed out. Here that order is a function of n alone:
+//   1. the input is cut into chunks of kParChunk elements (the last one may be
+//      short); chunk c covers [c * kParChunk, min(n, (c + 1) * kParChunk));
+//   2. each chunk is reduced by compute_kernel_vm, whose 16-lane order is
+//      fixed and independent of the vector width;
+//   3. the chunk partials are combined by a pairwise tree over chunk indices:
+//      at stride w = 1, 2, 4, ... p[i] += p[i + w] for i a multiple of 2w.
+// Threads only decide who computes which chunk, never how partials combine,
+// so the result is bit-identical for 1..N threads and across runs. It
+// differs from compute_kernel_vm(x, n) once n > kParChunk (different tree).
+//
+// The guarantee is for builds without -ffast-math, which lets the compiler
+// reassociate the lane sums; -ffp-contract does not matter (every fma in the
+// kernel is explicit).
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+#include "compute_kernel.hpp"
+
+inline constexpr std::size_t kParChunk = 1u << 14; // 64 KiB of input, multiple of kKernelBlock
+
+inline float compute_kernel_par(const float* x, std::size_t n, unsigned threads) {
+  const std::size_t chunks = (n + kParChunk - 1) / kParChunk;
+  if (chunks == 0) return 0.0f;
+  std::vector<float> partial(chunks);
+
+  // Dynamic hand-out for load balance; each partial lands in its own slot.
+  std::atomic<std::size_t> next{0};
+  auto worker = [&] {
+    for (std::size_t c; (c = next.fetch_add(1, std::memory_order_relaxed)) < chunks;) {
+      const std::size_t begin = c * kParChunk;
+      const std::size_t len = n - begin < kParChunk ? n - begin : kParChunk;
+      partial[c] = compute_kernel_vm(x + begin, len);
+    }
+  };
+  if (threads > chunks) threads = static_cast<unsigned>(chunks);
+  std::vector<std::jthread> pool;
+  for (unsigned t = 1; t < threads; ++t) pool.emplace_back(worker);
+  worker();
+  pool.clear(); // join: partials are published by the thread exits
+
+  for (std::size_t w = 1; w < chunks; w *= 2) {
+    for (std::size_t i = 0; i + w < chunks; i += 2 * w) partial[i] += partial[i + w];
+  }
+  return partial[0];
+}
@@ -0,0 +1,67 @@
+// parallel_kernel_bench.cpp — compute_kernel_par scaling, 1 thread .. all cores
+// Build target: parallel_kernel_bench
+//
+// Every iteration's result is compared bit-for-bit against the 1-thread
+// result; any mismatch fails the run.
+
+#include <benchmark/benchmark.h>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "compute_kernel.hpp"
+#include "parallel_kernel.hpp"
+#include "perf_counters.hpp"
+
+constexpr std::size_t kN = 1u << 24; // 64 MiB: 1024 chunks
+
+static const std::vector<float>& input() {
+  static const std::vector<float> x = [] {
+    std::vector<float> v(kN);
+    std::mt19937 rng(123);
+    std::uniform_real_distribution<float> dist(0.0f, 1.0f);
+    for (auto& e : v) e = dist(rng);
+    return v;
+  }();
+  return x;
+}
+
+static void BM_ComputeKernelPar(benchmark::State& st) {
+  const auto& x = input();
+  const unsigned threads = static_cast<unsigned>(st.range(0));
+  const std::uint32_t expect = std::bit_cast<std::uint32_t>(compute_kernel_par(x.data(), kN, 1));
+  std::int64_t mismatches = 0;
+  for (auto _ : perfc::counted(st)) {
+    const float s = compute_kernel_par(x.data(), kN, threads);
+    mismatches += std::bit_cast<std::uint32_t>(s) != expect;
+    benchmark::DoNotOptimize(s);
+  }
+  if (mismatches) st.SkipWithError("result differs from the 1-thread result");
+  st.SetItemsProcessed(static_cast<int64_t>(st.iterations() * kN));
+  st.SetBytesProcessed(static_cast<int64_t>(st.iterations() * kN * sizeof(float)));
+}
+
+// Powers of two up to the core count, plus the core count itself.
+static void ThreadCounts(benchmark::internal::Benchmark* b) {
+  const unsigned hw = std::thread::hardware_concurrency() ? std::thread::hardware_concurrency() : 1;
+  for (unsigned t = 1; t < hw; t *= 2) b->Arg(t);
+  b->Arg(hw);
+}
+BENCHMARK(BM_ComputeKernelPar)->Apply(ThreadCounts)->ArgName("threads")->UseRealTime();
+
+// Serial baseline: same per-chunk code path, no threads, different tree.
+static void BM_ComputeKernelVm(benchmark::State& st) {
+  const auto& x = input();
+  for (auto _ : perfc::counted(st)) {
+    float s = compute_kernel_vm(x.data(), kN);
+    benchmark::DoNotOptimize(s);
+  }
+  st.SetItemsProcessed(static_cast<int64_t>(st.iterations() * kN));
+  st.SetBytesProcessed(static_cast<int64_t>(st.iterations() * kN * sizeof(float)));
+}
+BENCHMARK(BM_ComputeKernelVm)->UseRealTime();
+
+BENCHMARK_MAIN();
@@ -0,0 +1,136 @@
+// sin_table.hpp — Table-driven sin/cos over a bounded domain, with linear or
+// cubic interpolation.
+//
+// SinCosTable<N, T, I>(lo, hi) samples sin and cos at N + 1 evenly spaced
+// nodes over [lo, hi], stored as (sin, cos) pairs of type T. A lookup finds
+// the cell, then interpolates:
+//   linear: from the two node values; error <= h^2 / 8 (h = (hi - lo) / N).
+//   cubic:  Hermite from the node values and their derivatives, which are the
+//           other column of the same pair (sin' = cos, cos' = -sin); error
+//           <= h^4 / 384. One pair load per end serves sin and cos.
+// On [0, 1) with T = float both reach the float rounding floor (~6e-8
+// absolute, measured in sin_table_bench) at linear N = 4096 (32 KiB) and
+// cubic N = 64 (520 B); past that, more cells only cost cache.
+//
+// The constructor is constexpr, so `constexpr SinCosTable<256> t(0.0, 1.0);`
+// builds the table at compile time. GCC's default constexpr operation limit
+// stops at N ~ 2^15 on [0, 1); larger tables are built at runtime by the
+// same code (std::make_unique<SinCosTable<...>>(lo, hi)).
+// Inputs outside [lo, hi], however large, are clamped to the end cells:
+// results there are extrapolations, not sin/cos. NaN in gives NaN out. The node values are exact to double precision
+// for |lo|, |hi| up to ~1e4 (the reduction uses a double 2*pi).
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace vmath {
+
+enum class Interp { linear, cubic };
+
+namespace table_detail {
+inline constexpr double kTwoPi = 6.283185307179586477;
+
+// Taylor series on x reduced to [-pi, pi]: std::sin is not constexpr here.
+// Stops once the next terms are below 1e-17 (at most 18 terms, at |r| = pi).
+constexpr void sincos(double x, double& s, double& c) {
+  const double k = x / kTwoPi;
+  const double r = x - kTwoPi * static_cast<double>(static_cast<long long>(k < 0 ? k - 0.5 : k + 0.5));
+  const double r2 = r * r;
+  double ts = r, tc = 1.0;
+  s = 0.0;
+  c = 0.0;
+  for (int n = 0; n < 18 && (ts > 1e-17 || ts < -1e-17 || tc > 1e-17 || tc < -1e-17); ++n) {
+    s += ts;
+    c += tc;
+    ts *= -r2 / ((2.0 * n + 2.0) * (2.0 * n + 3.0));
+    tc *= -r2 / ((2.0 * n + 1.0) * (2.0 * n + 2.0));
+  }
+}
+} // namespace table_detail
+
+template <std::size_t N, class T = float, Interp I = Interp::cubic>
+class SinCosTable {
+  static_assert(N >= 1 && N < (1u << 30), "cell index must fit in 32 bits");
+  static_assert(sizeof(T) == 4 || sizeof(T) == 8, "clamp reads T's bits as a 32- or 64-bit integer");
+
+public:
+  static constexpr std::size_t cells = N;
+  static constexpr std::size_t bytes = (N + 1) * 2 * sizeof(T);
+
+  constexpr SinCosTable(double lo, double hi)
+      : lo_(static_cast<T>(lo)), scale_(static_cast<T>(N / (hi - lo))), h_(static_cast<T>((hi - lo) / N)) {
+    for (std::size_t i = 0; i <= N; ++i) {
+      double s, c;
+      table_detail::sincos(lo + (hi - lo) * static_cast<double>(i) / N, s, c);
+      v_[2 * i] = static_cast<T>(s);
+      v_[2 * i + 1] = static_cast<T>(c);
+    }
+  }
+
+  // Straight-line, with the cell position clamped by integer min/max and
+  // scalar loads from the flat pair array, so the array form vectorizes into
+  // gathers. The clamp runs before the conversion to a 32-bit index, which is
+  // undefined for |u| >= 2^31 and NaN (x >= 128 already gets there for a
+  // 2^24-cell table on [0, 1)). It works on u's bit pattern, where signed
+  // integer order matches float order for u >= 0: every negative u (and -NaN)
+  // maps to 0, and +inf/+NaN land above kLast. A float clamp would be
+  // branches here, because without -fno-trapping-math GCC does not if-convert
+  // FP compares. t keeps the unclamped u, so clamped inputs extrapolate from
+  // the end cell.
+  constexpr void sincos(T x, T& s, T& c) const {
+    const T u = (x - lo_) * scale_;
+    const Bits b = std::min(std::max(std::bit_cast<Bits>(u), Bits{0}), kLastBits);
+    const std::int32_t i = static_cast<std::int32_t>(std::bit_cast<T>(b));
+    const T t = u - static_cast<T>(i);
+    const T s0 = v_[2 * i], c0 = v_[2 * i + 1];
+    const T s1 = v_[2 * i + 2], c1 = v_[2 * i + 3];
+    if constexpr (I == Interp::linear) {
+      s = s0 + t * (s1 - s0);
+      c = c0 + t * (c1 - c0);
+    } else {
+      s = hermite(s0, s1, h_ * c0, h_ * c1, t);
+      c = hermite(c0, c1, -h_ * s0, -h_ * s1, t);
+    }
+  }
+
+  constexpr T sin(T x) const {
+    T s, c;
+    sincos(x, s, c);
+    return s;
+  }
+
+  constexpr T cos(T x) const {
+    T s, c;
+    sincos(x, s, c);
+    return c;
+  }
+
+  // Array form (n elements, outputs may not alias inputs).
+  void sincos(const T* __restrict x, T* __restrict s, T* __restrict c, std::size_t n) const {
+    for (std::size_t k = 0; k < n; ++k) sincos(x[k], s[k], c[k]);
+  }
+
+private:
+  static constexpr std::int32_t kLast = static_cast<std::int32_t>(N - 1);
+  using Bits = std::conditional_t<sizeof(T) == 4, std::int32_t, std::int64_t>;
+  static constexpr Bits kLastBits = std::bit_cast<Bits>(static_cast<T>(kLast));
+
+  // Cubic through f0, f1 with end slopes d0, d1 (already scaled by h), Horner
+  // form in t.
+  static constexpr T hermite(T f0, T f1, T d0, T d1, T t) {
+    const T df = f1 - f0;
+    const T c2 = T(3) * df - T(2) * d0 - d1;
+    const T c3 = d0 + d1 - T(2) * df;
+    return f0 + t * (d0 + t * (c2 + t * c3));
+  }
+
+  T lo_, scale_, h_;
+  std::array<T, 2 * (N + 1)> v_{}; // sin, cos at node i: v_[2i], v_[2i + 1]
+};
+
+} // namespace vmath
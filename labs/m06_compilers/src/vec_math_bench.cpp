@@ -0,0 +1,101 @@
+// vec_math_bench.cpp — vmath kernels vs libm, 1<<20 floats per pass
+// Build target: vec_math_bench
+
+#include <benchmark/benchmark.h>
+#include <cmath>
+#include <cstddef>
+#include <random>
+#include <vector>
+
+#include "compute_kernel.hpp"
+#include "perf_counters.hpp"
+#include "vec_math.hpp"
+
+#if defined(__clang__) || defined(__GNUC__)
+  #define NOINLINE [[gnu::noinline]]
+#elif defined(_MSC_VER)
+  #define NOINLINE __declspec(noinline)
+#else
+  #define NOINLINE
+#endif
+
+constexpr std::size_t kN = 1u << 20;
+
+// kN floats uniform on [lo, hi), same seed every call. compute_kernel feeds
+// [0, 1), so the sqrt/rcp benches use [1, 2) (v + 1) and sincos [-8, 8).
+static std::vector<float> make_input(float lo, float hi) {
+  std::vector<float> x(kN);
+  std::mt19937 rng(123);
+  std::uniform_real_distribution<float> dist(lo, hi);
+  for (auto& v : x) v = dist(rng);
+  return x;
+}
+
+// libm baselines: opaque calls, so these loops stay scalar without fast-math.
+NOINLINE void libm_sincos(const float* __restrict x, float* __restrict s, float* __restrict c, std::size_t n) {
+  for (std::size_t i = 0; i < n; ++i) {
+    s[i] = std::sin(x[i]);
+    c[i] = std::cos(x[i]);
+  }
+}
+NOINLINE void libm_sqrt(const float* __restrict x, float* __restrict y, std::size_t n) {
+  for (std::size_t i = 0; i < n; ++i) y[i] = std::sqrt(x[i]);
+}
+NOINLINE void libm_rsqrt(const float* __restrict x, float* __restrict y, std::size_t n) {
+  for (std::size_t i = 0; i < n; ++i) y[i] = 1.0f / std::sqrt(x[i]);
+}
+NOINLINE void div_rcp(const float* __restrict x, float* __restrict y, std::size_t n) {
+  for (std::size_t i = 0; i < n; ++i) y[i] = 1.0f / x[i];
+}
+
+NOINLINE void vm_sincos(const float* x, float* s, float* c, std::size_t n) { vmath::sincos(x, s, c, n); }
+NOINLINE void vm_sqrt(const float* x, float* y, std::size_t n) { vmath::sqrt(x, y, n); }
+NOINLINE void vm_rsqrt(const float* x, float* y, std::size_t n) { vmath::rsqrt(x, y, n); }
+NOINLINE void vm_rcp(const float* x, float* y, std::size_t n) { vmath::rcp(x, y, n); }
+
+template <void (*F)(const float*, float*, float*, std::size_t)>
+static void BM_SinCos(benchmark::State& st) {
+  const auto x = make_input(-8.0f, 8.0f);
+  std::vector<float> s(kN), c(kN);
+  for (auto _ : perfc::counted(st)) {
+    F(x.data(), s.data(), c.data(), kN);
+    benchmark::DoNotOptimize(s.data());
+    benchmark::DoNotOptimize(c.data());
+    benchmark::ClobberMemory();
+  }
+  st.SetItemsProcessed(static_cast<int64_t>(st.iterations() * kN));
+}
+BENCHMARK_TEMPLATE(BM_SinCos, libm_sincos);
+BENCHMARK_TEMPLATE(BM_SinCos, vm_sincos);
+
+template <void (*F)(const float*, float*, std::size_t)>
+static void BM_Unary(benchmark::State& st) {
+  const auto x = make_input(1.0f, 2.0f); // sqrt(v + 1), 1 / (v + 1) in compute_kernel
+  std::vector<float> y(kN);
+  for (auto _ : perfc::counted(st)) {
+    F(x.data(), y.data(), kN);
+    benchmark::DoNotOptimize(y.data());
+    benchmark::ClobberMemory();
+  }
+  st.SetItemsProcessed(static_cast<int64_t>(st.iterations() * kN));
+}
+BENCHMARK_TEMPLATE(BM_Unary, libm_sqrt);
+BENCHMARK_TEMPLATE(BM_Unary, vm_sqrt);
+BENCHMARK_TEMPLATE(BM_Unary, libm_rsqrt);
+BENCHMARK_TEMPLATE(BM_Unary, vm_rsqrt);
+BENCHMARK_TEMPLATE(BM_Unary, div_rcp);
+BENCHMARK_TEMPLATE(BM_Unary, vm_rcp);
+
+template <float (*K)(const float*, std::size_t)>
+static void BM_ComputeKernel(benchmark::State& st) {
+  const auto x = make_input(0.0f, 1.0f);
+  for (auto _ : perfc::counted(st)) {
+    float s = K(x.data(), kN);
+    benchmark::DoNotOptimize(s);
+  }
+  st.SetItemsProcessed(static_cast<int64_t>(st.iterations() * kN));
+}
+BENCHMARK_TEMPLATE(BM_ComputeKernel, compute_kernel);
+BENCHMARK_TEMPLATE(BM_ComputeKernel, compute_kernel_vm);
+
+BENCHMARK_MAIN();